@@ -5,6 +5,10 @@
 
 #include <private/qobject_p.h>
 
+#include <qtgamepad_tracepoints_p.h>
+
+#include <utility>
+
 QT_BEGIN_NAMESPACE
 
 class QGamepadPrivate : public QObjectPrivate
@@ -12,60 +16,263 @@ class QGamepadPrivate : public QObjectPrivate
     Q_DECLARE_PUBLIC(QGamepad)
 
 public:
-    QGamepadPrivate(int deviceId)
-        : deviceId(deviceId)
+    QGamepadPrivate(int id)
     {
+        deviceId.setValueBypassingBindings(id);
     }
 
-    int deviceId = -1;
-    bool connected = false;
-    QString name;
-    float axisLeftX = 0.0f;
-    float axisLeftY = 0.0f;
-    float axisRightX = 0.0f;
-    float axisRightY = 0.0f;
-    bool buttonA = false;
-    bool buttonB = false;
-    bool buttonX = false;
-    bool buttonY = false;
-    bool buttonL1 = false;
-    bool buttonR1 = false;
-    float buttonL2 = 0.0f;
-    float buttonR2 = 0.0f;
-    bool buttonSelect = false;
-    bool buttonStart = false;
-    bool buttonL3 = false;
-    bool buttonR3 = false;
-    bool buttonUp = false;
-    bool buttonDown = false;
-    bool buttonLeft = false;
-    bool buttonRight = false;
-    bool buttonGuide = false;
+    enum StateField : quint32 {
+        AxisLeftX = 1u << 0,
+        AxisLeftY = 1u << 1,
+        AxisRightX = 1u << 2,
+        AxisRightY = 1u << 3,
+        ButtonA = 1u << 4,
+        ButtonB = 1u << 5,
+        ButtonX = 1u << 6,
+        ButtonY = 1u << 7,
+        ButtonL1 = 1u << 8,
+        ButtonR1 = 1u << 9,
+        ButtonL2 = 1u << 10,
+        ButtonR2 = 1u << 11,
+        ButtonSelect = 1u << 12,
+        ButtonStart = 1u << 13,
+        ButtonL3 = 1u << 14,
+        ButtonR3 = 1u << 15,
+        ButtonUp = 1u << 16,
+        ButtonDown = 1u << 17,
+        ButtonLeft = 1u << 18,
+        ButtonRight = 1u << 19,
+        ButtonGuide = 1u << 20,
+    };
+
+    struct State {
+        float axisLeftX = 0.0f;
+        float axisLeftY = 0.0f;
+        float axisRightX = 0.0f;
+        float axisRightY = 0.0f;
+        bool buttonA = false;
+        bool buttonB = false;
+        bool buttonX = false;
+        bool buttonY = false;
+        bool buttonL1 = false;
+        bool buttonR1 = false;
+        float buttonL2 = 0.0f;
+        float buttonR2 = 0.0f;
+        bool buttonSelect = false;
+        bool buttonStart = false;
+        bool buttonL3 = false;
+        bool buttonR3 = false;
+        bool buttonUp = false;
+        bool buttonDown = false;
+        bool buttonLeft = false;
+        bool buttonRight = false;
+        bool buttonGuide = false;
+    };
+
+    void emitDeviceIdChanged();
+    void emitConnectedChanged() { Q_EMIT q_func()->connectedChanged(); }
+    void emitNameChanged() { Q_EMIT q_func()->nameChanged(); }
+    void emitAxisLeftXChanged() { Q_EMIT q_func()->axisLeftXChanged(); }
+    void emitAxisLeftYChanged() { Q_EMIT q_func()->axisLeftYChanged(); }
+    void emitAxisRightXChanged() { Q_EMIT q_func()->axisRightXChanged(); }
+    void emitAxisRightYChanged() { Q_EMIT q_func()->axisRightYChanged(); }
+    void emitButtonAChanged() { Q_EMIT q_func()->buttonAChanged(); }
+    void emitButtonBChanged() { Q_EMIT q_func()->buttonBChanged(); }
+    void emitButtonXChanged() { Q_EMIT q_func()->buttonXChanged(); }
+    void emitButtonYChanged() { Q_EMIT q_func()->buttonYChanged(); }
+    void emitButtonL1Changed() { Q_EMIT q_func()->buttonL1Changed(); }
+    void emitButtonR1Changed() { Q_EMIT q_func()->buttonR1Changed(); }
+    void emitButtonL2Changed() { Q_EMIT q_func()->buttonL2Changed(); }
+    void emitButtonR2Changed() { Q_EMIT q_func()->buttonR2Changed(); }
+    void emitButtonSelectChanged() { Q_EMIT q_func()->buttonSelectChanged(); }
+    void emitButtonStartChanged() { Q_EMIT q_func()->buttonStartChanged(); }
+    void emitButtonL3Changed() { Q_EMIT q_func()->buttonL3Changed(); }
+    void emitButtonR3Changed() { Q_EMIT q_func()->buttonR3Changed(); }
+    void emitButtonUpChanged() { Q_EMIT q_func()->buttonUpChanged(); }
+    void emitButtonDownChanged() { Q_EMIT q_func()->buttonDownChanged(); }
+    void emitButtonLeftChanged() { Q_EMIT q_func()->buttonLeftChanged(); }
+    void emitButtonRightChanged() { Q_EMIT q_func()->buttonRightChanged(); }
+    void emitButtonGuideChanged() { Q_EMIT q_func()->buttonGuideChanged(); }
+    void emitButtonsChanged() { Q_EMIT q_func()->buttonsChanged(); }
+    void emitLeftStickChanged() { Q_EMIT q_func()->leftStickChanged(); }
+    void emitRightStickChanged() { Q_EMIT q_func()->rightStickChanged(); }
+    void emitTriggersChanged() { Q_EMIT q_func()->triggersChanged(); }
+    void emitTimestampChanged() { Q_EMIT q_func()->timestampChanged(); }
+
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, int, deviceId, -1, &QGamepadPrivate::emitDeviceIdChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, bool, connected, false, &QGamepadPrivate::emitConnectedChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(QGamepadPrivate, QString, name, &QGamepadPrivate::emitNameChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, float, axisLeftX, 0.0f, &QGamepadPrivate::emitAxisLeftXChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, float, axisLeftY, 0.0f, &QGamepadPrivate::emitAxisLeftYChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, float, axisRightX, 0.0f, &QGamepadPrivate::emitAxisRightXChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, float, axisRightY, 0.0f, &QGamepadPrivate::emitAxisRightYChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, bool, buttonA, false, &QGamepadPrivate::emitButtonAChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, bool, buttonB, false, &QGamepadPrivate::emitButtonBChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, bool, buttonX, false, &QGamepadPrivate::emitButtonXChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, bool, buttonY, false, &QGamepadPrivate::emitButtonYChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, bool, buttonL1, false, &QGamepadPrivate::emitButtonL1Changed)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, bool, buttonR1, false, &QGamepadPrivate::emitButtonR1Changed)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, float, buttonL2, 0.0f, &QGamepadPrivate::emitButtonL2Changed)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, float, buttonR2, 0.0f, &QGamepadPrivate::emitButtonR2Changed)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, bool, buttonSelect, false, &QGamepadPrivate::emitButtonSelectChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, bool, buttonStart, false, &QGamepadPrivate::emitButtonStartChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, bool, buttonL3, false, &QGamepadPrivate::emitButtonL3Changed)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, bool, buttonR3, false, &QGamepadPrivate::emitButtonR3Changed)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, bool, buttonUp, false, &QGamepadPrivate::emitButtonUpChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, bool, buttonDown, false, &QGamepadPrivate::emitButtonDownChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, bool, buttonLeft, false, &QGamepadPrivate::emitButtonLeftChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, bool, buttonRight, false, &QGamepadPrivate::emitButtonRightChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, bool, buttonGuide, false, &QGamepadPrivate::emitButtonGuideChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, int, buttons, 0, &QGamepadPrivate::emitButtonsChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(QGamepadPrivate, QVector2D, leftStick, &QGamepadPrivate::emitLeftStickChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(QGamepadPrivate, QVector2D, rightStick, &QGamepadPrivate::emitRightStickChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(QGamepadPrivate, QVector2D, triggers, &QGamepadPrivate::emitTriggersChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(QGamepadPrivate, qint64, timestamp, 0, &QGamepadPrivate::emitTimestampChanged)
+
+    QGamepad::UpdateMode updateMode = QGamepad::ImmediateUpdates;
+
+    // Incoming values are collected here until they are published to the
+    // bindable properties above.
+    State staged;
+    qint64 stagedTimestamp = 0;
+    quint32 dirty = 0;
 
     void setConnected(bool isConnected);
     void setName(const QString &name);
 
+    template <typename T>
+    void stage(StateField field, T State::*member, T value);
+    void publish();
+    int stagedButtons() const;
+
     void _q_handleGamepadConnectionChangedEvent(int index, bool isConnected);
     void _q_handleGamepadAxisEvent(int device, JoyAxis axis, float value);
     void _q_handleGamepadButtonEvent(int device, JoyButton button, bool isPressed);
 };
 
-void QGamepadPrivate::setConnected(bool isConnected)
+void QGamepadPrivate::emitDeviceIdChanged()
 {
     Q_Q(QGamepad);
-    if (connected != isConnected) {
-        connected = isConnected;
-        emit q->connectedChanged();
-    }
+    // Whatever was staged or published belongs to the previous device. All
+    // of it is reset in one update group, so that the packed and the
+    // individual properties never disagree.
+    staged = State();
+    stagedTimestamp = 0;
+    dirty = ~0u;
+    publish();
+    emit q->deviceIdChanged();
+    auto input = QUniversalInput::instance();
+    setName(input->getJoyName(deviceId));
+    setConnected(input->isJoyConnected(deviceId));
+}
+
+void QGamepadPrivate::setConnected(bool isConnected)
+{
+    connected.setValue(isConnected);
 }
 
 void QGamepadPrivate::setName(const QString &theName)
+{
+    name.setValue(theName);
+}
+
+template <typename T>
+void QGamepadPrivate::stage(StateField field, T State::*member, T value)
 {
     Q_Q(QGamepad);
-    if (name != theName) {
-        name = theName;
-        emit q->nameChanged();
+    staged.*member = value;
+    // When the device reported the sample, not when it got here
+    stagedTimestamp = QUniversalInput::instance()->eventTimestamp() / (1000 * 1000);
+
+    if (updateMode == QGamepad::ImmediateUpdates) {
+        dirty |= field;
+        publish();
+        return;
     }
+
+    const bool wasIdle = dirty == 0;
+    dirty |= field;
+    if (wasIdle)
+        emit q->synchronizationRequested();
+}
+
+void QGamepadPrivate::publish()
+{
+    const quint32 fields = std::exchange(dirty, 0u);
+    if (!fields)
+        return;
+
+    Q_TRACE_SCOPE(QGamepad_publish, deviceId.valueBypassingBindings(), fields);
+
+    QScopedPropertyUpdateGroup updateGroup;
+
+    // setValue() only notifies when the value actually changes
+    auto publishField = [&](StateField field, auto property, auto member) {
+        if (fields & field)
+            (this->*property).setValue(staged.*member);
+    };
+
+    publishField(AxisLeftX, &QGamepadPrivate::axisLeftX, &State::axisLeftX);
+    publishField(AxisLeftY, &QGamepadPrivate::axisLeftY, &State::axisLeftY);
+    publishField(AxisRightX, &QGamepadPrivate::axisRightX, &State::axisRightX);
+    publishField(AxisRightY, &QGamepadPrivate::axisRightY, &State::axisRightY);
+    publishField(ButtonA, &QGamepadPrivate::buttonA, &State::buttonA);
+    publishField(ButtonB, &QGamepadPrivate::buttonB, &State::buttonB);
+    publishField(ButtonX, &QGamepadPrivate::buttonX, &State::buttonX);
+    publishField(ButtonY, &QGamepadPrivate::buttonY, &State::buttonY);
+    publishField(ButtonL1, &QGamepadPrivate::buttonL1, &State::buttonL1);
+    publishField(ButtonR1, &QGamepadPrivate::buttonR1, &State::buttonR1);
+    publishField(ButtonL2, &QGamepadPrivate::buttonL2, &State::buttonL2);
+    publishField(ButtonR2, &QGamepadPrivate::buttonR2, &State::buttonR2);
+    publishField(ButtonSelect, &QGamepadPrivate::buttonSelect, &State::buttonSelect);
+    publishField(ButtonStart, &QGamepadPrivate::buttonStart, &State::buttonStart);
+    publishField(ButtonL3, &QGamepadPrivate::buttonL3, &State::buttonL3);
+    publishField(ButtonR3, &QGamepadPrivate::buttonR3, &State::buttonR3);
+    publishField(ButtonUp, &QGamepadPrivate::buttonUp, &State::buttonUp);
+    publishField(ButtonDown, &QGamepadPrivate::buttonDown, &State::buttonDown);
+    publishField(ButtonLeft, &QGamepadPrivate::buttonLeft, &State::buttonLeft);
+    publishField(ButtonRight, &QGamepadPrivate::buttonRight, &State::buttonRight);
+    publishField(ButtonGuide, &QGamepadPrivate::buttonGuide, &State::buttonGuide);
+
+    // The packed properties change together with the individual ones, so
+    // bindings never see a stick with only one of its axes updated.
+    constexpr quint32 leftStickFields = AxisLeftX | AxisLeftY;
+    constexpr quint32 rightStickFields = AxisRightX | AxisRightY;
+    constexpr quint32 triggerFields = ButtonL2 | ButtonR2;
+    constexpr quint32 buttonFields = ~(leftStickFields | rightStickFields | triggerFields);
+
+    if (fields & buttonFields)
+        buttons.setValue(stagedButtons());
+    if (fields & leftStickFields)
+        leftStick.setValue(QVector2D(staged.axisLeftX, staged.axisLeftY));
+    if (fields & rightStickFields)
+        rightStick.setValue(QVector2D(staged.axisRightX, staged.axisRightY));
+    if (fields & triggerFields)
+        triggers.setValue(QVector2D(staged.buttonL2, staged.buttonR2));
+    timestamp.setValue(stagedTimestamp);
+}
+
+int QGamepadPrivate::stagedButtons() const
+{
+    auto bit = [](bool pressed, JoyButton button) {
+        return pressed ? 1 << int(button) : 0;
+    };
+
+    return bit(staged.buttonA, JoyButton::A)
+        | bit(staged.buttonB, JoyButton::B)
+        | bit(staged.buttonX, JoyButton::X)
+        | bit(staged.buttonY, JoyButton::Y)
+        | bit(staged.buttonSelect, JoyButton::Back)
+        | bit(staged.buttonGuide, JoyButton::Guide)
+        | bit(staged.buttonStart, JoyButton::Start)
+        | bit(staged.buttonL3, JoyButton::LeftStick)
+        | bit(staged.buttonR3, JoyButton::RightStick)
+        | bit(staged.buttonL1, JoyButton::LeftShoulder)
+        | bit(staged.buttonR1, JoyButton::RightShoulder)
+        | bit(staged.buttonUp, JoyButton::DpadUp)
+        | bit(staged.buttonDown, JoyButton::DpadDown)
+        | bit(staged.buttonLeft, JoyButton::DpadLeft)
+        | bit(staged.buttonRight, JoyButton::DpadRight);
 }
 
 /*!
@@ -82,34 +289,27 @@ void QGamepadPrivate::_q_handleGamepadConnectionChangedEvent(int index, bool isC
  */\
 void QGamepadPrivate::_q_handleGamepadAxisEvent(int device, JoyAxis axis, float value)
 {
-    Q_Q(QGamepad);
     if (device != deviceId)
         return;
 
     switch (axis) {
     case JoyAxis::LeftX:
-        axisLeftX = value;
-        emit q->axisLeftXChanged();
+        stage(AxisLeftX, &State::axisLeftX, value);
         break;
     case JoyAxis::LeftY:
-        axisLeftY = value;
-        emit q->axisLeftYChanged();
+        stage(AxisLeftY, &State::axisLeftY, value);
         break;
     case JoyAxis::RightX:
-        axisRightX = value;
-        emit q->axisRightXChanged();
+        stage(AxisRightX, &State::axisRightX, value);
         break;
     case JoyAxis::RightY:
-        axisRightY = value;
-        emit q->axisRightYChanged();
+        stage(AxisRightY, &State::axisRightY, value);
         break;
     case JoyAxis::TriggerLeft:
-        buttonL2 = value;
-        emit q->buttonL2Changed();
+        stage(ButtonL2, &State::buttonL2, value);
         break;
     case JoyAxis::TriggerRight:
-        buttonR2 = value;
-        emit q->buttonR2Changed();
+        stage(ButtonR2, &State::buttonR2, value);
         break;
     default:
         break;
@@ -121,70 +321,54 @@ void QGamepadPrivate::_q_handleGamepadAxisEvent(int device, JoyAxis axis, float
  */\
 void QGamepadPrivate::_q_handleGamepadButtonEvent(int device, JoyButton button, bool isPressed)
 {
-    Q_Q(QGamepad);
     if (device != deviceId)
         return;
 
     switch (button) {
     case JoyButton::A:
-        buttonA = isPressed;
-        emit q->buttonAChanged();
+        stage(ButtonA, &State::buttonA, isPressed);
         break;
     case JoyButton::B:
-        buttonB = isPressed;
-        emit q->buttonBChanged();
+        stage(ButtonB, &State::buttonB, isPressed);
         break;
     case JoyButton::X:
-        buttonX = isPressed;
-        emit q->buttonXChanged();
+        stage(ButtonX, &State::buttonX, isPressed);
         break;
     case JoyButton::Y:
-        buttonY = isPressed;
-        emit q->buttonYChanged();
+        stage(ButtonY, &State::buttonY, isPressed);
         break;
     case JoyButton::LeftShoulder:
-        buttonL1 = isPressed;
-        emit q->buttonL1Changed();
+        stage(ButtonL1, &State::buttonL1, isPressed);
         break;
     case JoyButton::RightShoulder:
-        buttonR1 = isPressed;
-        emit q->buttonR1Changed();
+        stage(ButtonR1, &State::buttonR1, isPressed);
         break;
     case JoyButton::LeftStick:
-        buttonL3 = isPressed;
-        emit q->buttonL3Changed();
+        stage(ButtonL3, &State::buttonL3, isPressed);
         break;
     case JoyButton::RightStick:
-        buttonR3 = isPressed;
-        emit q->buttonR3Changed();
+        stage(ButtonR3, &State::buttonR3, isPressed);
         break;
     case JoyButton::Back:
-        buttonSelect = isPressed;
-        emit q->buttonSelectChanged();
+        stage(ButtonSelect, &State::buttonSelect, isPressed);
         break;
     case JoyButton::Start:
-        buttonStart = isPressed;
-        emit q->buttonStartChanged();
+        stage(ButtonStart, &State::buttonStart, isPressed);
         break;
     case JoyButton::DpadUp:
-        buttonUp = isPressed;
-        emit q->buttonUpChanged();
+        stage(ButtonUp, &State::buttonUp, isPressed);
         break;
     case JoyButton::DpadDown:
-        buttonDown = isPressed;
-        emit q->buttonDownChanged();
+        stage(ButtonDown, &State::buttonDown, isPressed);
         break;
     case JoyButton::DpadLeft:
-        buttonLeft = isPressed;
-        emit q->buttonLeftChanged();
+        stage(ButtonLeft, &State::buttonLeft, isPressed);
         break;
     case JoyButton::DpadRight:
-        buttonRight = isPressed;
-        emit q->buttonRightChanged();
+        stage(ButtonRight, &State::buttonRight, isPressed);
         break;
     case JoyButton::Guide:
-        buttonGuide = isPressed;
-        emit q->buttonGuideChanged();
+        stage(ButtonGuide, &State::buttonGuide, isPressed);
         break;
     default:
         break;
@@ -706,16 +890,336 @@ bool QGamepad::buttonGuide() const
     return d->buttonGuide;
 }
 
+/*!
+ * \property QGamepad::buttons
+ *
+ * The state of all buttons packed into a bit mask. Bit \c n is set when
+ * the button with the \c JoyButton value \c n is pressed.
+ *
+ * This property changes together with the individual button properties,
+ * so a single binding can follow every button of the gamepad.
+ */
+/*!
+ * \qmlproperty int Gamepad::buttons
+ * \readonly
+ *
+ * The state of all buttons packed into a bit mask. Bit \c n is set when
+ * the button with the \c JoyButton value \c n is pressed.
+ */
+int QGamepad::buttons() const
+{
+    Q_D(const QGamepad);
+    return d->buttons;
+}
+
+/*!
+ * \property QGamepad::leftStick
+ *
+ * The X and Y axes of the left thumbstick, updated together.
+ */
+/*!
+ * \qmlproperty vector2d Gamepad::leftStick
+ * \readonly
+ *
+ * The X and Y axes of the left thumbstick, updated together.
+ */
+QVector2D QGamepad::leftStick() const
+{
+    Q_D(const QGamepad);
+    return d->leftStick;
+}
+
+/*!
+ * \property QGamepad::rightStick
+ *
+ * The X and Y axes of the right thumbstick, updated together.
+ */
+/*!
+ * \qmlproperty vector2d Gamepad::rightStick
+ * \readonly
+ *
+ * The X and Y axes of the right thumbstick, updated together.
+ */
+QVector2D QGamepad::rightStick() const
+{
+    Q_D(const QGamepad);
+    return d->rightStick;
+}
+
+/*!
+ * \property QGamepad::triggers
+ *
+ * The left trigger value as \c x and the right trigger value as \c y.
+ */
+/*!
+ * \qmlproperty vector2d Gamepad::triggers
+ * \readonly
+ *
+ * The left trigger value as \c x and the right trigger value as \c y.
+ */
+QVector2D QGamepad::triggers() const
+{
+    Q_D(const QGamepad);
+    return d->triggers;
+}
+
+/*!
+ * \property QGamepad::timestamp
+ *
+ * The time, in milliseconds of the monotonic clock used by QDeadlineTimer,
+ * at which the device reported the latest published sample.
+ */
+/*!
+ * \qmlproperty qint64 Gamepad::timestamp
+ * \readonly
+ *
+ * The time, in milliseconds of a monotonic clock, at which the device
+ * reported the latest published sample.
+ */
+qint64 QGamepad::timestamp() const
+{
+    Q_D(const QGamepad);
+    return d->timestamp;
+}
+
+/*!
+ * \enum QGamepad::UpdateMode
+ *
+ * This enum describes when changes to the gamepad state are published.
+ *
+ * \value ImmediateUpdates Every incoming sample updates the properties and
+ *        emits their change signals right away.
+ * \value FrameSynchronizedUpdates Incoming samples are staged and published
+ *        when synchronize() is called, at most one change signal per property.
+ */
+
+/*!
+ * \property QGamepad::updateMode
+ *
+ * This property holds when changes to the gamepad state are published.
+ * The default is \l ImmediateUpdates.
+ *
+ * In \l FrameSynchronizedUpdates mode the synchronizationRequested() signal
+ * is emitted when the first change is staged after a synchronize(), so that
+ * the owner of the frame clock can schedule one.
+ */
+/*!
+ * \qmlproperty enumeration Gamepad::updateMode
+ *
+ * This property holds when changes to the gamepad state are published.
+ * With \c Gamepad.FrameSynchronizedUpdates changes are published once per
+ * frame of the window the gamepad belongs to, right after animations have
+ * advanced. The default is \c Gamepad.ImmediateUpdates.
+ */
+QGamepad::UpdateMode QGamepad::updateMode() const
+{
+    Q_D(const QGamepad);
+    return d->updateMode;
+}
+
+void QGamepad::setUpdateMode(UpdateMode mode)
+{
+    Q_D(QGamepad);
+    if (d->updateMode == mode)
+        return;
+
+    d->updateMode = mode;
+    // Do not leave anything staged behind when switching back
+    if (mode == ImmediateUpdates)
+        d->publish();
+    emit updateModeChanged();
+}
+
+/*!
+ * Publishes the staged gamepad state, emitting the change signal of every
+ * property whose value differs from the last published one.
+ *
+ * This is only needed in \l FrameSynchronizedUpdates mode.
+ */
+void QGamepad::synchronize()
+{
+    Q_D(QGamepad);
+    d->publish();
+}
+
 void QGamepad::setDeviceId(int number)
 {
     Q_D(QGamepad);
-    if (d->deviceId != number) {
-        d->deviceId = number;
-        emit deviceIdChanged();
-        auto input = QUniversalInput::instance();
-        d->setName(input->getJoyName(d->deviceId));
-        d->setConnected(input->isJoyConnected(d->deviceId));
-    }
+    d->deviceId.setValue(number);
+}
+
+QBindable<int> QGamepad::bindableDeviceId()
+{
+    Q_D(QGamepad);
+    return &d->deviceId;
+}
+
+QBindable<bool> QGamepad::bindableConnected() const
+{
+    Q_D(const QGamepad);
+    return &d->connected;
+}
+
+QBindable<QString> QGamepad::bindableName() const
+{
+    Q_D(const QGamepad);
+    return &d->name;
+}
+
+QBindable<int> QGamepad::bindableButtons() const
+{
+    Q_D(const QGamepad);
+    return &d->buttons;
+}
+
+QBindable<QVector2D> QGamepad::bindableLeftStick() const
+{
+    Q_D(const QGamepad);
+    return &d->leftStick;
+}
+
+QBindable<QVector2D> QGamepad::bindableRightStick() const
+{
+    Q_D(const QGamepad);
+    return &d->rightStick;
+}
+
+QBindable<QVector2D> QGamepad::bindableTriggers() const
+{
+    Q_D(const QGamepad);
+    return &d->triggers;
+}
+
+QBindable<qint64> QGamepad::bindableTimestamp() const
+{
+    Q_D(const QGamepad);
+    return &d->timestamp;
+}
+
+QBindable<float> QGamepad::bindableAxisLeftX() const
+{
+    Q_D(const QGamepad);
+    return &d->axisLeftX;
+}
+
+QBindable<float> QGamepad::bindableAxisLeftY() const
+{
+    Q_D(const QGamepad);
+    return &d->axisLeftY;
+}
+
+QBindable<float> QGamepad::bindableAxisRightX() const
+{
+    Q_D(const QGamepad);
+    return &d->axisRightX;
+}
+
+QBindable<float> QGamepad::bindableAxisRightY() const
+{
+    Q_D(const QGamepad);
+    return &d->axisRightY;
+}
+
+QBindable<bool> QGamepad::bindableButtonA() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonA;
+}
+
+QBindable<bool> QGamepad::bindableButtonB() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonB;
+}
+
+QBindable<bool> QGamepad::bindableButtonX() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonX;
+}
+
+QBindable<bool> QGamepad::bindableButtonY() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonY;
+}
+
+QBindable<bool> QGamepad::bindableButtonL1() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonL1;
+}
+
+QBindable<bool> QGamepad::bindableButtonR1() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonR1;
+}
+
+QBindable<float> QGamepad::bindableButtonL2() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonL2;
+}
+
+QBindable<float> QGamepad::bindableButtonR2() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonR2;
+}
+
+QBindable<bool> QGamepad::bindableButtonSelect() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonSelect;
+}
+
+QBindable<bool> QGamepad::bindableButtonStart() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonStart;
+}
+
+QBindable<bool> QGamepad::bindableButtonL3() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonL3;
+}
+
+QBindable<bool> QGamepad::bindableButtonR3() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonR3;
+}
+
+QBindable<bool> QGamepad::bindableButtonUp() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonUp;
+}
+
+QBindable<bool> QGamepad::bindableButtonDown() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonDown;
+}
+
+QBindable<bool> QGamepad::bindableButtonLeft() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonLeft;
+}
+
+QBindable<bool> QGamepad::bindableButtonRight() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonRight;
+}
+
+QBindable<bool> QGamepad::bindableButtonGuide() const
+{
+    Q_D(const QGamepad);
+    return &d->buttonGuide;
 }
 
 QT_END_NAMESPACE
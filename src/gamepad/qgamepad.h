@@ -5,6 +5,8 @@
 #define QGAMEPAD_H
 
 #include <QtCore/QObject>
+#include <QtCore/QProperty>
+#include <QtGui/QVector2D>
 #include <QtGamepad/qtgamepadexports.h>
 #include <QtUniversalInput/quniversalinput.h>
 
@@ -15,31 +17,43 @@ class QGamepadPrivate;
 class Q_GAMEPAD_EXPORT QGamepad : public QObject
 {
     Q_OBJECT
-    Q_PROPERTY(int deviceId READ deviceId WRITE setDeviceId NOTIFY deviceIdChanged)
-    Q_PROPERTY(bool connected READ isConnected NOTIFY connectedChanged)
-    Q_PROPERTY(QString name READ name NOTIFY nameChanged)
-    Q_PROPERTY(float axisLeftX READ axisLeftX NOTIFY axisLeftXChanged)
-    Q_PROPERTY(float axisLeftY READ axisLeftY NOTIFY axisLeftYChanged)
-    Q_PROPERTY(float axisRightX READ axisRightX NOTIFY axisRightXChanged)
-    Q_PROPERTY(float axisRightY READ axisRightY NOTIFY axisRightYChanged)
-    Q_PROPERTY(bool buttonA READ buttonA NOTIFY buttonAChanged)
-    Q_PROPERTY(bool buttonB READ buttonB NOTIFY buttonBChanged)
-    Q_PROPERTY(bool buttonX READ buttonX NOTIFY buttonXChanged)
-    Q_PROPERTY(bool buttonY READ buttonY NOTIFY buttonYChanged)
-    Q_PROPERTY(bool buttonL1 READ buttonL1 NOTIFY buttonL1Changed)
-    Q_PROPERTY(bool buttonR1 READ buttonR1 NOTIFY buttonR1Changed)
-    Q_PROPERTY(float buttonL2 READ buttonL2 NOTIFY buttonL2Changed)
-    Q_PROPERTY(float buttonR2 READ buttonR2 NOTIFY buttonR2Changed)
-    Q_PROPERTY(bool buttonSelect READ buttonSelect NOTIFY buttonSelectChanged)
-    Q_PROPERTY(bool buttonStart READ buttonStart NOTIFY buttonStartChanged)
-    Q_PROPERTY(bool buttonL3 READ buttonL3 NOTIFY buttonL3Changed)
-    Q_PROPERTY(bool buttonR3 READ buttonR3 NOTIFY buttonR3Changed)
-    Q_PROPERTY(bool buttonUp READ buttonUp NOTIFY buttonUpChanged)
-    Q_PROPERTY(bool buttonDown READ buttonDown NOTIFY buttonDownChanged)
-    Q_PROPERTY(bool buttonLeft READ buttonLeft NOTIFY buttonLeftChanged)
-    Q_PROPERTY(bool buttonRight READ buttonRight NOTIFY buttonRightChanged)
-    Q_PROPERTY(bool buttonGuide READ buttonGuide NOTIFY buttonGuideChanged)
+    Q_PROPERTY(int deviceId READ deviceId WRITE setDeviceId NOTIFY deviceIdChanged BINDABLE bindableDeviceId)
+    Q_PROPERTY(bool connected READ isConnected NOTIFY connectedChanged BINDABLE bindableConnected)
+    Q_PROPERTY(QString name READ name NOTIFY nameChanged BINDABLE bindableName)
+    Q_PROPERTY(float axisLeftX READ axisLeftX NOTIFY axisLeftXChanged BINDABLE bindableAxisLeftX)
+    Q_PROPERTY(float axisLeftY READ axisLeftY NOTIFY axisLeftYChanged BINDABLE bindableAxisLeftY)
+    Q_PROPERTY(float axisRightX READ axisRightX NOTIFY axisRightXChanged BINDABLE bindableAxisRightX)
+    Q_PROPERTY(float axisRightY READ axisRightY NOTIFY axisRightYChanged BINDABLE bindableAxisRightY)
+    Q_PROPERTY(bool buttonA READ buttonA NOTIFY buttonAChanged BINDABLE bindableButtonA)
+    Q_PROPERTY(bool buttonB READ buttonB NOTIFY buttonBChanged BINDABLE bindableButtonB)
+    Q_PROPERTY(bool buttonX READ buttonX NOTIFY buttonXChanged BINDABLE bindableButtonX)
+    Q_PROPERTY(bool buttonY READ buttonY NOTIFY buttonYChanged BINDABLE bindableButtonY)
+    Q_PROPERTY(bool buttonL1 READ buttonL1 NOTIFY buttonL1Changed BINDABLE bindableButtonL1)
+    Q_PROPERTY(bool buttonR1 READ buttonR1 NOTIFY buttonR1Changed BINDABLE bindableButtonR1)
+    Q_PROPERTY(float buttonL2 READ buttonL2 NOTIFY buttonL2Changed BINDABLE bindableButtonL2)
+    Q_PROPERTY(float buttonR2 READ buttonR2 NOTIFY buttonR2Changed BINDABLE bindableButtonR2)
+    Q_PROPERTY(bool buttonSelect READ buttonSelect NOTIFY buttonSelectChanged BINDABLE bindableButtonSelect)
+    Q_PROPERTY(bool buttonStart READ buttonStart NOTIFY buttonStartChanged BINDABLE bindableButtonStart)
+    Q_PROPERTY(bool buttonL3 READ buttonL3 NOTIFY buttonL3Changed BINDABLE bindableButtonL3)
+    Q_PROPERTY(bool buttonR3 READ buttonR3 NOTIFY buttonR3Changed BINDABLE bindableButtonR3)
+    Q_PROPERTY(bool buttonUp READ buttonUp NOTIFY buttonUpChanged BINDABLE bindableButtonUp)
+    Q_PROPERTY(bool buttonDown READ buttonDown NOTIFY buttonDownChanged BINDABLE bindableButtonDown)
+    Q_PROPERTY(bool buttonLeft READ buttonLeft NOTIFY buttonLeftChanged BINDABLE bindableButtonLeft)
+    Q_PROPERTY(bool buttonRight READ buttonRight NOTIFY buttonRightChanged BINDABLE bindableButtonRight)
+    Q_PROPERTY(bool buttonGuide READ buttonGuide NOTIFY buttonGuideChanged BINDABLE bindableButtonGuide)
+    Q_PROPERTY(int buttons READ buttons NOTIFY buttonsChanged BINDABLE bindableButtons)
+    Q_PROPERTY(QVector2D leftStick READ leftStick NOTIFY leftStickChanged BINDABLE bindableLeftStick)
+    Q_PROPERTY(QVector2D rightStick READ rightStick NOTIFY rightStickChanged BINDABLE bindableRightStick)
+    Q_PROPERTY(QVector2D triggers READ triggers NOTIFY triggersChanged BINDABLE bindableTriggers)
+    Q_PROPERTY(qint64 timestamp READ timestamp NOTIFY timestampChanged BINDABLE bindableTimestamp)
+    Q_PROPERTY(UpdateMode updateMode READ updateMode WRITE setUpdateMode NOTIFY updateModeChanged)
 public:
+    enum UpdateMode {
+        ImmediateUpdates,
+        FrameSynchronizedUpdates,
+    };
+    Q_ENUM(UpdateMode)
+
     explicit QGamepad(int deviceId = 0, QObject *parent = nullptr);
     ~QGamepad();
 
@@ -72,6 +86,48 @@ public:
     bool buttonRight() const;
     bool buttonGuide() const;
 
+    int buttons() const;
+    QVector2D leftStick() const;
+    QVector2D rightStick() const;
+    QVector2D triggers() const;
+    qint64 timestamp() const;
+
+    QBindable<int> bindableDeviceId();
+    QBindable<bool> bindableConnected() const;
+    QBindable<QString> bindableName() const;
+    QBindable<float> bindableAxisLeftX() const;
+    QBindable<float> bindableAxisLeftY() const;
+    QBindable<float> bindableAxisRightX() const;
+    QBindable<float> bindableAxisRightY() const;
+    QBindable<bool> bindableButtonA() const;
+    QBindable<bool> bindableButtonB() const;
+    QBindable<bool> bindableButtonX() const;
+    QBindable<bool> bindableButtonY() const;
+    QBindable<bool> bindableButtonL1() const;
+    QBindable<bool> bindableButtonR1() const;
+    QBindable<float> bindableButtonL2() const;
+    QBindable<float> bindableButtonR2() const;
+    QBindable<bool> bindableButtonSelect() const;
+    QBindable<bool> bindableButtonStart() const;
+    QBindable<bool> bindableButtonL3() const;
+    QBindable<bool> bindableButtonR3() const;
+    QBindable<bool> bindableButtonUp() const;
+    QBindable<bool> bindableButtonDown() const;
+    QBindable<bool> bindableButtonLeft() const;
+    QBindable<bool> bindableButtonRight() const;
+    QBindable<bool> bindableButtonGuide() const;
+    QBindable<int> bindableButtons() const;
+    QBindable<QVector2D> bindableLeftStick() const;
+    QBindable<QVector2D> bindableRightStick() const;
+    QBindable<QVector2D> bindableTriggers() const;
+    QBindable<qint64> bindableTimestamp() const;
+
+    UpdateMode updateMode() const;
+    void setUpdateMode(UpdateMode mode);
+
+public Q_SLOTS:
+    void synchronize();
+
 Q_SIGNALS:
 
     void deviceIdChanged();
@@ -98,6 +154,13 @@ Q_SIGNALS:
     void buttonLeftChanged();
     void buttonRightChanged();
     void buttonGuideChanged();
+    void buttonsChanged();
+    void leftStickChanged();
+    void rightStickChanged();
+    void triggersChanged();
+    void timestampChanged();
+    void updateModeChanged();
+    void synchronizationRequested();
 
 private:
     Q_DECLARE_PRIVATE(QGamepad)
@@ -0,0 +1,56 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef EVDEVCAPTURE_H
+#define EVDEVCAPTURE_H
+
+#include <QtCore/qglobal.h>
+
+#include <linux/input.h>
+
+QT_BEGIN_NAMESPACE
+
+// File format of the raw evdev captures written by LinuxJoystickInput when
+// QT_UNIVERSALINPUT_EVDEV_CAPTURE names a directory, and played back through
+// uinput by the qevdevreplay tool.
+//
+// A capture is a Header describing the device, followed by every
+// input_event read from it as an Event. Everything is in host byte order,
+// and the capability bitmaps are laid out the way EVIOCGBIT returns them on
+// little endian hosts.
+namespace EvdevCapture {
+
+constexpr char Magic[4] = { 'Q', 'E', 'V', 'C' };
+constexpr quint32 Version = 1;
+
+struct Header {
+    char magic[4];
+    quint32 version;
+    input_id id;
+    char name[128];
+    quint8 evbit[EV_CNT / 8 + 1];
+    quint8 keybit[KEY_CNT / 8 + 1];
+    quint8 absbit[ABS_CNT / 8 + 1];
+    quint8 ffbit[FF_CNT / 8 + 1];
+    // Only valid for the axes set in absbit
+    input_absinfo absinfo[ABS_CNT];
+};
+
+struct Event {
+    qint64 sec;
+    qint64 usec;
+    quint16 type;
+    quint16 code;
+    qint32 value;
+};
+
+inline bool testBit(const quint8 *bits, int bit)
+{
+    return bits[bit / 8] & (1 << (bit % 8));
+}
+
+} // namespace EvdevCapture
+
+QT_END_NAMESPACE
+
+#endif // EVDEVCAPTURE_H
@@ -8,14 +8,22 @@
 */
 
 #include "linuxjoystickinput.h"
+#include "evdevcapture.h"
 
+#include <qtlinuxjoystickinputplugin_tracepoints_p.h>
+
+#include <QtCore/QDateTime>
 #include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/qmath.h>
 
 #include <libudev.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <string.h>
+#include <time.h>
 #include <linux/input.h>
 
 using namespace Qt::Literals::StringLiterals;
@@ -30,8 +38,33 @@ QT_BEGIN_NAMESPACE
 static QString ignore_str = u"js"_s;
 // GODOT end
 
+// Accelerometer resolutions are given in units per g
+static constexpr float StandardGravity = 9.80665f;
+
 LinuxJoystickInput::LinuxJoystickInput()
     : m_udev(nullptr)
+    , m_captureDir(qEnvironmentVariable("QT_UNIVERSALINPUT_EVDEV_CAPTURE"))
+{
+}
+
+LinuxJoystickInput::~LinuxJoystickInput()
+{
+    if (m_monitor)
+        udev_monitor_unref(m_monitor);
+    m_monitor = nullptr;
+
+    if (m_udev)
+        udev_unref(m_udev);
+
+    m_udev = nullptr;
+}
+
+QJoystickInput::Capabilities LinuxJoystickInput::capabilities() const
+{
+    return PollDriven | Hotplug | Rumble | DeviceTimestamps | MotionSensors | Touchpad;
+}
+
+bool LinuxJoystickInput::start(EventSink &sink)
 {
     m_udev = udev_new();
     if (!m_udev) {
@@ -39,23 +72,79 @@ LinuxJoystickInput::LinuxJoystickInput()
         m_udev = nullptr; // ensure udev is nullptr
     }
 
-    probeJoypads();
+    probeJoypads(sink);
+
+    // Watch for hotplug instead of enumerating all input devices every tick
+    if (m_udev) {
+        m_monitor = udev_monitor_new_from_netlink(m_udev, "udev");
+        if (m_monitor) {
+            udev_monitor_filter_add_match_subsystem_devtype(m_monitor, "input", nullptr);
+            udev_monitor_enable_receiving(m_monitor);
+        }
+    }
 
     m_elapsedTimer.start();
+    return true;
+}
+
+void LinuxJoystickInput::stop(EventSink &sink)
+{
+    closeJoypads(sink);
 
-    // ### Replace with Thread later
-    startTimer(1);
+    if (m_monitor)
+        udev_monitor_unref(m_monitor);
+    m_monitor = nullptr;
 }
 
-LinuxJoystickInput::~LinuxJoystickInput()
+// The udev monitor and every node of the open devices, so that the driver
+// wakes us up as soon as there is something to read instead of polling on
+// a timer
+QList<qintptr> LinuxJoystickInput::pollDescriptors() const
 {
-    if (m_udev)
-        udev_unref(m_udev);
+    QList<qintptr> descriptors;
+    if (m_monitor)
+        descriptors.append(udev_monitor_get_fd(m_monitor));
+    for (const auto &joypad : m_joypads) {
+        descriptors.append(joypad->fd);
+        if (joypad->motion)
+            descriptors.append(joypad->motion->fd);
+        if (joypad->touch)
+            descriptors.append(joypad->touch->fd);
+    }
+    return descriptors;
+}
 
-    m_udev = nullptr;
+int LinuxJoystickInput::pollInterval() const
+{
+    // Without a udev monitor we can only find new devices by polling
+    return m_monitor ? -1 : 1000;
 }
 
-void LinuxJoystickInput::probeJoypads()
+void LinuxJoystickInput::poll(EventSink &sink)
+{
+    if (m_monitor)
+        processMonitor(sink);
+    else
+        probeJoypads(sink);
+    processJoypads(sink);
+}
+
+bool LinuxJoystickInput::setRumble(int device, float weakMagnitude, float strongMagnitude, int durationMs)
+{
+    gamepad *joypad = this->joypad(device);
+    if (!joypad || !joypad->force_feedback)
+        return false;
+
+    gamepad &joy = *joypad;
+    // The kernel stops the effect once its length has been played
+    if (durationMs <= 0 || (weakMagnitude <= 0.0f && strongMagnitude <= 0.0f))
+        joypadVibrationStop(joy, 0);
+    else
+        joypadVibrationStart(joy, weakMagnitude, strongMagnitude, durationMs, 0);
+    return true;
+}
+
+void LinuxJoystickInput::probeJoypads(EventSink &sink)
 {
     if (!m_udev) {
         qWarning() << "Could not probe joypads, udev is not initialized";
@@ -78,11 +167,9 @@ void LinuxJoystickInput::probeJoypads()
             QString devnode_str = devnode;
 
             // check if exists
-            if (std::find(m_attached_devices.begin(), m_attached_devices.end(), devnode_str) != m_attached_devices.end())
-                continue;
-
-            if (!devnode_str.contains(ignore_str))
-                setupJoypadObject(devnode_str);
+            const bool attached = std::find(m_attached_devices.begin(), m_attached_devices.end(), devnode_str) != m_attached_devices.end();
+            if (!attached && !devnode_str.contains(ignore_str))
+                setupJoypadObject(devnode_str, sink);
         }
 
         udev_device_unref(dev);
@@ -90,6 +177,27 @@ void LinuxJoystickInput::probeJoypads()
     udev_enumerate_unref(enumerate);
 }
 
+void LinuxJoystickInput::processMonitor(EventSink &sink)
+{
+    // The monitor socket is non-blocking, drain everything queued
+    while (udev_device *dev = udev_monitor_receive_device(m_monitor)) {
+        const char *action = udev_device_get_action(dev);
+        const char *devnode = udev_device_get_devnode(dev);
+        if (action && devnode) {
+            const QString devnode_str = QString::fromUtf8(devnode);
+            if (qstrcmp(action, "add") == 0) {
+                const bool attached = std::find(m_attached_devices.begin(), m_attached_devices.end(), devnode_str) != m_attached_devices.end();
+                if (!attached && !devnode_str.contains(ignore_str))
+                    setupJoypadObject(devnode_str, sink);
+            } else if (qstrcmp(action, "remove") == 0) {
+                closeJoypad(devnode, sink);
+            }
+        }
+
+        udev_device_unref(dev);
+    }
+}
+
 static inline uint16_t BSWAP16(uint16_t x)
 {
     return (x >> 8) | (x << 8);
@@ -102,15 +210,8 @@ static inline QString _hex_str(QChar c)
     return str;
 }
 
-void LinuxJoystickInput::setupJoypadObject(const QString &device)
+void LinuxJoystickInput::setupJoypadObject(const QString &device, EventSink &sink)
 {
-    auto input = QUniversalInput::instance();
-    int id = input->getUnusedJoyId();
-    if (id == -1) {
-        qWarning() << "Could not find unused joypad";
-        return;
-    }
-
     // GODOT begin ; dont know what is godot and what is ours now
     // tries to open the device to check if it's a joystick
     int fd = open(device.toUtf8().constData(), O_RDWR | O_NONBLOCK);
@@ -127,6 +228,11 @@ void LinuxJoystickInput::setupJoypadObject(const QString &device)
     // add to attached devices so we don't try to open it again
     m_attached_devices.push_back(device);
 
+    // Report event times on the monotonic clock QDeadlineTimer uses, so
+    // they can be compared with the time the events are delivered.
+    int clockId = CLOCK_MONOTONIC;
+    ioctl(fd, EVIOCSCLOCKID, &clockId);
+
     if ((ioctl(fd, EVIOCGBIT(0, sizeof(evbit)), evbit) < 0) ||
         (ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keybit)), keybit) < 0) ||
         (ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absbit)), absbit) < 0)) {
@@ -134,6 +240,20 @@ void LinuxJoystickInput::setupJoypadObject(const QString &device)
         return;
     }
 
+    // Motion sensors come as a node of their own, without any buttons
+    unsigned long propbit[NBITS(INPUT_PROP_MAX)] = { 0 };
+    if (ioctl(fd, EVIOCGPROP(sizeof(propbit)), propbit) >= 0 && test_bit(INPUT_PROP_ACCELEROMETER, propbit)) {
+        setupMotionNode(device, fd, absbit);
+        return;
+    }
+    // So do touchpads, which would otherwise pass for a joypad with ABS_X
+    // and ABS_Y. Touchscreens are neither pointers nor button pads.
+    if (test_bit(ABS_MT_SLOT, absbit)
+        && (test_bit(INPUT_PROP_POINTER, propbit) || test_bit(INPUT_PROP_BUTTONPAD, propbit))) {
+        setupTouchNode(device, fd, absbit);
+        return;
+    }
+
     // Check if the device supports basic gamepad events
     bool has_abs_left = (test_bit(ABS_X, absbit) && test_bit(ABS_Y, absbit));
     bool has_abs_right = (test_bit(ABS_RX, absbit) && test_bit(ABS_RY, absbit));
@@ -154,26 +274,44 @@ void LinuxJoystickInput::setupJoypadObject(const QString &device)
         return;
     }
 
-    // reset gamepad
-    m_joypads[id] = gamepad();
-    auto& joy = m_joypads[id];
+    // Identifies the device interface, so that other backends reporting the
+    // same device are recognized as duplicates
+    char physbuf[128] = {};
+    QString phys;
+    if (ioctl(fd, EVIOCGPHYS(sizeof(physbuf) - 1), physbuf) >= 0)
+        phys = QString::fromLatin1(physbuf);
+
+    // Slots are shared with the other backends, only take one now that the
+    // device is known to be usable
+    const int id = sink.allocateDevice();
+    if (id == -1) {
+        qWarning() << "Could not find unused joypad";
+        m_attached_devices.pop_back();
+        close(fd);
+        return;
+    }
+
+    m_joypads.push_back(std::make_unique<gamepad>());
+    auto& joy = *m_joypads.back();
     joy.fd = fd;
     joy.devpath = QString(device);
-    joy.attached = true;
     joy.id = id;
-    joy.vibrating = false;
+    joy.parent = parentDevice(fd);
 
     setupJoypadProperties(&joy);
+    if (!m_captureDir.isEmpty())
+        startCapture(joy);
 
     char uid[64];
     sprintf(uid, "%04x%04x", BSWAP16(inpid.bustype), 0);
+    bool registered = false;
     if (inpid.vendor && inpid.product && inpid.version) {
         uint16_t vendor = BSWAP16(inpid.vendor);
         uint16_t product = BSWAP16(inpid.product);
         uint16_t version = BSWAP16(inpid.version);
 
         sprintf(uid + QString(uid).length(), "%04x%04x%04x%04x%04x%04x", vendor, 0, product, 0, version, 0);
-        input->updateJoyConnection(id, true, "Udev Joypad", uid);
+        registered = sink.connectionChanged(id, true, "Udev Joypad", uid, phys);
     } else {
         QString uidname = uid;
         int uidlen = std::min((int)name.length(), 11);
@@ -181,10 +319,159 @@ void LinuxJoystickInput::setupJoypadObject(const QString &device)
             uidname = uidname + _hex_str(name[i]);
         }
         uidname += "00";
-        input->updateJoyConnection(id, true, "Udev Joypad", uidname);
+        registered = sink.connectionChanged(id, true, "Udev Joypad", uidname, phys);
     }
 
     // GODOT end
+
+    // Another backend already provides this device. It stays in the
+    // attached devices, so that it is not probed again until removed.
+    if (!registered) {
+        m_joypads.pop_back();
+        return;
+    }
+    linkSiblingNodes();
+    Q_EMIT pollDescriptorsChanged();
+}
+
+void LinuxJoystickInput::setupMotionNode(const QString &device, int fd, const unsigned long *absbit)
+{
+    auto sensors = std::make_unique<MotionNode>();
+    sensors->fd = fd;
+    sensors->devpath = device;
+    sensors->parent = parentDevice(fd);
+
+    // Axes without a resolution can not be converted and stay at 0
+    for (int code = ABS_X; code <= ABS_RZ; code++) {
+        input_absinfo absinfo;
+        if (!test_bit(code, absbit) || ioctl(fd, EVIOCGABS(code), &absinfo) < 0 || absinfo.resolution <= 0)
+            continue;
+        const float unit = code < ABS_RX ? StandardGravity : qDegreesToRadians(1.0f);
+        sensors->scale[code] = unit / absinfo.resolution;
+    }
+
+    m_motionNodes.push_back(std::move(sensors));
+    linkSiblingNodes();
+    Q_EMIT pollDescriptorsChanged();
+}
+
+// Touchpads of other devices, e.g. that of a laptop, are kept open but never
+// linked, so that they are not probed again
+void LinuxJoystickInput::setupTouchNode(const QString &device, int fd, const unsigned long *absbit)
+{
+    auto touch = std::make_unique<TouchNode>();
+    touch->fd = fd;
+    touch->devpath = device;
+    touch->parent = parentDevice(fd);
+
+    input_absinfo absinfo;
+    if (ioctl(fd, EVIOCGABS(ABS_MT_SLOT), &absinfo) >= 0)
+        touch->slotCount = qBound(0, absinfo.maximum + 1, int(TOUCH_SLOTS_MAX));
+    if (ioctl(fd, EVIOCGABS(ABS_MT_POSITION_X), &absinfo) >= 0) {
+        touch->minimumX = absinfo.minimum;
+        touch->maximumX = absinfo.maximum;
+    }
+    if (ioctl(fd, EVIOCGABS(ABS_MT_POSITION_Y), &absinfo) >= 0) {
+        touch->minimumY = absinfo.minimum;
+        touch->maximumY = absinfo.maximum;
+    }
+    if (test_bit(ABS_MT_PRESSURE, absbit) && ioctl(fd, EVIOCGABS(ABS_MT_PRESSURE), &absinfo) >= 0)
+        touch->maximumPressure = qMax(0, absinfo.maximum);
+
+    m_touchNodes.push_back(std::move(touch));
+    linkSiblingNodes();
+    Q_EMIT pollDescriptorsChanged();
+}
+
+// Any node of a gamepad may show up first. Once both did, the sibling node
+// moves into the gamepad and is read along with it. What it queued until
+// then is stale and discarded, its state is read from the kernel instead.
+void LinuxJoystickInput::linkSiblingNodes()
+{
+    auto gamepadFor = [this](const QString &parent) -> gamepad * {
+        for (const auto &joypad : m_joypads) {
+            if (!parent.isEmpty() && joypad->parent == parent)
+                return joypad.get();
+        }
+        return nullptr;
+    };
+    auto drain = [](int fd) {
+        input_event events[EVENT_BATCH_SIZE];
+        while (read(fd, events, sizeof(events)) > 0) { }
+    };
+
+    for (auto it = m_motionNodes.begin(); it != m_motionNodes.end();) {
+        gamepad *joy = gamepadFor((*it)->parent);
+        if (!joy || joy->motion) {
+            ++it;
+            continue;
+        }
+        joy->motion = std::move(*it);
+        it = m_motionNodes.erase(it);
+        joy->motion->id = joy->id;
+        joy->motion->dropped = false;
+        drain(joy->motion->fd);
+        resyncMotionNode(*joy->motion);
+    }
+
+    for (auto it = m_touchNodes.begin(); it != m_touchNodes.end();) {
+        gamepad *joy = gamepadFor((*it)->parent);
+        if (!joy || joy->touch) {
+            ++it;
+            continue;
+        }
+        joy->touch = std::move(*it);
+        it = m_touchNodes.erase(it);
+        joy->touch->id = joy->id;
+        joy->touch->dropped = false;
+        drain(joy->touch->fd);
+        resyncTouchNode(*joy->touch);
+    }
+}
+
+// Reads the current axes, when the node joins its gamepad and after
+// SYN_DROPPED
+void LinuxJoystickInput::resyncMotionNode(MotionNode &sensors)
+{
+    for (int code = ABS_X; code <= ABS_RZ; code++) {
+        input_absinfo absinfo;
+        if (sensors.scale[code] != 0.0f && ioctl(sensors.fd, EVIOCGABS(code), &absinfo) >= 0)
+            sensors.raw[code] = absinfo.value;
+    }
+}
+
+// Identifies the physical device a node belongs to: the HID device the
+// kernel driver creates all its nodes for, or failing that the unique id,
+// e.g. the Bluetooth address, the driver gives each of them
+QString LinuxJoystickInput::parentDevice(int fd) const
+{
+    struct stat st;
+    if (m_udev && fstat(fd, &st) == 0) {
+        if (udev_device *dev = udev_device_new_from_devnum(m_udev, 'c', st.st_rdev)) {
+            // Owned by dev
+            udev_device *hid = udev_device_get_parent_with_subsystem_devtype(dev, "hid", nullptr);
+            const QString path = hid ? QString::fromUtf8(udev_device_get_syspath(hid)) : QString();
+            udev_device_unref(dev);
+            if (!path.isEmpty())
+                return path;
+        }
+    }
+
+    char uniq[64] = {};
+    if (ioctl(fd, EVIOCGUNIQ(sizeof(uniq) - 1), uniq) >= 0 && uniq[0])
+        return u"uniq:"_s + QString::fromLatin1(uniq);
+
+    // Last the physical path without the interface, e.g.
+    // "usb-0000:00:14.0-2" of "usb-0000:00:14.0-2/input3"
+    char phys[128] = {};
+    if (ioctl(fd, EVIOCGPHYS(sizeof(phys) - 1), phys) >= 0 && phys[0]) {
+        QString path = QString::fromLatin1(phys);
+        const qsizetype slash = path.lastIndexOf(u'/');
+        if (slash > 0 && QStringView(path).mid(slash + 1).startsWith(u"input"))
+            path.truncate(slash);
+        return u"phys:"_s + path;
+    }
+    return QString();
 }
 
 void LinuxJoystickInput::setupJoypadProperties(gamepad* joy)
@@ -193,20 +480,17 @@ void LinuxJoystickInput::setupJoypadProperties(gamepad* joy)
     unsigned long keybit[NBITS(KEY_MAX)] = { 0 };
     unsigned long absbit[NBITS(ABS_MAX)] = { 0 };
 
-    int num_buttons = 0;
-    int num_axes = 0;
-
     if ((ioctl(joy->fd, EVIOCGBIT(EV_KEY, sizeof(keybit)), keybit) < 0) ||
         (ioctl(joy->fd, EVIOCGBIT(EV_ABS, sizeof(absbit)), absbit) < 0)) {
         return;
     }
     for (int i = BTN_JOYSTICK; i < KEY_MAX; ++i)
         if (test_bit(i, keybit))
-            joy->key_map[i] = num_buttons++;
+            joy->buttonCodes.append(i);
 
     for (int i = BTN_MISC; i < BTN_JOYSTICK; ++i)
         if (test_bit(i, keybit))
-            joy->key_map[i] = num_buttons++;
+            joy->buttonCodes.append(i);
 
     for (int i = 0; i < ABS_MISC; ++i) {
         /* Skip hats */
@@ -215,12 +499,9 @@ void LinuxJoystickInput::setupJoypadProperties(gamepad* joy)
             continue;
         }
         if (test_bit(i, absbit)) {
-            joy->joy_axis[i] = num_axes++;
-            joy->abs_info[i] = new input_absinfo;
-            if (ioctl(joy->fd, EVIOCGABS(i), joy->abs_info[i]) < 0) {
-                delete joy->abs_info[i];
-                joy->abs_info[i] = nullptr;
-            }
+            input_absinfo absinfo;
+            if (ioctl(joy->fd, EVIOCGABS(i), &absinfo) >= 0)
+                joy->absAxes.append({ quint16(i), absinfo.minimum, absinfo.maximum });
         }
     }
 
@@ -234,33 +515,165 @@ void LinuxJoystickInput::setupJoypadProperties(gamepad* joy)
     // GODOT end
 }
 
-void LinuxJoystickInput::closeJoypads()
+void LinuxJoystickInput::closeJoypads(EventSink &sink)
+{
+    while (!m_joypads.empty())
+        closeJoypad(m_joypads.back()->id, sink);
+
+    // Now holds the sibling nodes of the closed gamepads as well
+    for (const auto &sensors : m_motionNodes)
+        forgetDevice(sensors->devpath);
+    for (const auto &touch : m_touchNodes)
+        forgetDevice(touch->devpath);
+    m_motionNodes.clear();
+    m_touchNodes.clear();
+}
+
+void LinuxJoystickInput::closeJoypad(const char *p_devpath, EventSink &sink)
 {
-    for (int i = 0; i < JOYPADS_MAX; i++) {
-        gamepad &joypad = m_joypads[i];
-        closeJoypad(joypad, i);
+    const QString devpath = QString::fromLocal8Bit(p_devpath);
+    for (size_t i = 0; i < m_joypads.size(); i++) {
+        gamepad *joy = m_joypads[i].get();
+        if (joy->devpath == devpath) {
+            closeJoypad(joy->id, sink);
+            break;
+        } else if (joy->motion && joy->motion->devpath == devpath) {
+            joy->motion.reset();
+            Q_EMIT pollDescriptorsChanged();
+        } else if (joy->touch && joy->touch->devpath == devpath) {
+            // Lift the fingers that were down
+            sink.touch(joy->id, nullptr, 0, 0);
+            joy->touch.reset();
+            Q_EMIT pollDescriptorsChanged();
+        }
     }
+
+    const auto sensors = std::find_if(m_motionNodes.begin(), m_motionNodes.end(), [&devpath](const auto &entry) {
+        return entry->devpath == devpath;
+    });
+    if (sensors != m_motionNodes.end())
+        m_motionNodes.erase(sensors);
+
+    const auto touch = std::find_if(m_touchNodes.begin(), m_touchNodes.end(), [&devpath](const auto &entry) {
+        return entry->devpath == devpath;
+    });
+    if (touch != m_touchNodes.end())
+        m_touchNodes.erase(touch);
+
+    // Also forget nodes that were probed but rejected, so that a device
+    // reusing the node later on gets probed again
+    forgetDevice(devpath);
+}
+
+void LinuxJoystickInput::closeJoypad(int p_id, EventSink &sink)
+{
+    const auto it = std::find_if(m_joypads.begin(), m_joypads.end(), [p_id](const auto &joypad) {
+        return joypad->id == p_id;
+    });
+    if (it == m_joypads.end())
+        return;
+
+    // Destroying the gamepad closes its file descriptor. Its sibling nodes
+    // stay open and wait for the gamepad node to come back.
+    const auto joypad = std::move(*it);
+    m_joypads.erase(it);
+    forgetDevice(joypad->devpath);
+    if (joypad->motion) {
+        joypad->motion->id = -1;
+        m_motionNodes.push_back(std::move(joypad->motion));
+    }
+    if (joypad->touch) {
+        joypad->touch->id = -1;
+        m_touchNodes.push_back(std::move(joypad->touch));
+    }
+    sink.connectionChanged(p_id, false, QString(), QString(), QString());
+    Q_EMIT pollDescriptorsChanged();
+}
+
+LinuxJoystickInput::gamepad *LinuxJoystickInput::joypad(int id) const
+{
+    for (const auto &joypad : m_joypads) {
+        if (joypad->id == id)
+            return joypad.get();
+    }
+    return nullptr;
+}
+
+void LinuxJoystickInput::forgetDevice(const QString &devpath)
+{
+    const auto it = std::find(m_attached_devices.begin(), m_attached_devices.end(), devpath);
+    if (it != m_attached_devices.end())
+        m_attached_devices.erase(it);
 }
 
-void LinuxJoystickInput::closeJoypad(const char *p_devpath)
+// Dumps the device description and from then on every event read from it,
+// so that the device can be recreated with uinput by qevdevreplay.
+void LinuxJoystickInput::startCapture(gamepad &joy)
 {
-    for (int i = 0; i < JOYPADS_MAX; i++) {
-        gamepad &joypad = m_joypads[i];
-        if (m_joypads[i].devpath == p_devpath)
-            closeJoypad(joypad, i);
+    EvdevCapture::Header header = {};
+    memcpy(header.magic, EvdevCapture::Magic, sizeof(header.magic));
+    header.version = EvdevCapture::Version;
+
+    if ((ioctl(joy.fd, EVIOCGID, &header.id) < 0) ||
+        (ioctl(joy.fd, EVIOCGNAME(sizeof(header.name) - 1), header.name) < 0) ||
+        (ioctl(joy.fd, EVIOCGBIT(0, sizeof(header.evbit)), header.evbit) < 0) ||
+        (ioctl(joy.fd, EVIOCGBIT(EV_KEY, sizeof(header.keybit)), header.keybit) < 0) ||
+        (ioctl(joy.fd, EVIOCGBIT(EV_ABS, sizeof(header.absbit)), header.absbit) < 0)) {
+        qWarning() << "Could not query" << joy.devpath << "for capture";
+        return;
+    }
+    ioctl(joy.fd, EVIOCGBIT(EV_FF, sizeof(header.ffbit)), header.ffbit);
+
+    for (int i = 0; i < ABS_CNT; i++) {
+        if (EvdevCapture::testBit(header.absbit, i))
+            ioctl(joy.fd, EVIOCGABS(i), &header.absinfo[i]);
+    }
+
+    const QString fileName = u"%1/%2-%3.evcap"_s.arg(m_captureDir, QFileInfo(joy.devpath).fileName())
+                                     .arg(QDateTime::currentMSecsSinceEpoch());
+    auto capture = std::make_unique<QFile>(fileName);
+    if (!capture->open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not open evdev capture" << fileName << capture->errorString();
+        return;
     }
+    capture->write(reinterpret_cast<const char *>(&header), sizeof(header));
+    joy.capture = std::move(capture);
 }
 
-void LinuxJoystickInput::closeJoypad(gamepad &p_joypad, int p_id)
+LinuxJoystickInput::gamepad::~gamepad()
 {
-    auto input = QUniversalInput::instance();
+    if (fd != -1)
+        close(fd);
+}
+
+LinuxJoystickInput::MotionNode::~MotionNode()
+{
+    if (fd != -1)
+        close(fd);
+}
 
-    if (p_joypad.fd != -1) {
-        close(p_joypad.fd);
-        p_joypad.fd = -1;
-        m_attached_devices.erase(std::find(m_attached_devices.begin(), m_attached_devices.end(), p_joypad.devpath));
-        input->updateJoyConnection(p_id, false, "");
+LinuxJoystickInput::TouchNode::~TouchNode()
+{
+    if (fd != -1)
+        close(fd);
+}
+
+int LinuxJoystickInput::gamepad::buttonForCode(int code) const
+{
+    for (qsizetype i = 0; i < buttonCodes.size(); ++i) {
+        if (buttonCodes[i] == code)
+            return int(i);
+    }
+    return -1;
+}
+
+const LinuxJoystickInput::gamepad::AbsAxis *LinuxJoystickInput::gamepad::absAxisForCode(int code) const
+{
+    for (const AbsAxis &axis : absAxes) {
+        if (axis.code == code)
+            return &axis;
     }
+    return nullptr;
 }
 
 static inline float axisCorrect(int value, int min, int max)
@@ -268,127 +681,391 @@ static inline float axisCorrect(int value, int min, int max)
     return 2.0f * (value - min) / (max - min) - 1.0f;
 }
 
-void LinuxJoystickInput::processJoypads()
+static inline qint64 eventTime(const input_event &event)
 {
-    auto input = QUniversalInput::instance();
+    return qint64(event.input_event_sec) * 1000000000 + qint64(event.input_event_usec) * 1000;
+}
 
-    for (int i = 0; i < JOYPADS_MAX; i++) {
-        gamepad& joy = m_joypads[i];
-        if (!joy.attached)
-            continue;
+void LinuxJoystickInput::processJoypadEvents(gamepad &joy, const input_event *events, int count, EventSink &sink)
+{
+    // GODOT begin
 
-        // get joypad events
-        input_event event;
-        std::vector<input_event> events;
-        while (read(joy.fd, &event, sizeof(event)) > 0) {
-            events.push_back(event);
+    for (int e = 0; e < count; ++e) {
+        const input_event &event = events[e];
+
+        const qint64 timestamp = eventTime(event);
+
+        switch (event.type) {
+        case EV_SYN:
+            // The kernel queue of the device overflowed and events were lost
+            if (event.code == SYN_DROPPED)
+                sink.eventsDropped(joy.id);
+            else if (event.code == SYN_REPORT)
+                Q_TRACE(LinuxJoystickInput_synReport, joy.id, timestamp);
+            break;
+
+        case EV_KEY: {
+            // Ignore codes the device did not announce
+            const int button = joy.buttonForCode(event.code);
+            if (button != -1 && button < int(JoyButton::MAX))
+                sink.button(joy.id, JoyButton(button), event.value, timestamp);
+            break;
         }
 
-        if (errno != EAGAIN) {
-            closeJoypad(joy, i);
+        case EV_ABS:
+            switch (event.code) {
+            case ABS_HAT0X:
+                if (event.value != 0) {
+                    if (event.value < 0) {
+                        joy.dpad = HatMask::Left;
+                    } else {
+                        joy.dpad = HatMask::Right;
+                    }
+                } else {
+                    joy.dpad = HatMask::Center;
+                }
+                sink.hat(joy.id, joy.dpad, timestamp);
+                break;
+
+            case ABS_HAT0Y:
+                if (event.value != 0) {
+                    if (event.value < 0) {
+                        joy.dpad = HatMask::Up;
+                    } else {
+                        joy.dpad = HatMask::Down;
+                    }
+                } else {
+                    joy.dpad = HatMask::Center;
+                }
+                sink.hat(joy.id, joy.dpad, timestamp);
+                break;
+
+            default:
+                if (const auto *absAxis = joy.absAxisForCode(event.code)) {
+                    // using the min/max values from the device
+                    auto min = absAxis->minimum;
+                    auto max = absAxis->maximum;
+
+                    float value = event.value;
+                    value = axisCorrect(value, min, max);
+
+                    JoyAxis axis = JoyAxis::Invalid;
+
+                    switch (event.code) {
+                    case ABS_X:
+                        axis = JoyAxis::LeftX;
+                        break;
+                    case ABS_Y:
+                        axis = JoyAxis::LeftY;
+                        break;
+                    case ABS_RX:
+                        axis = JoyAxis::RightX;
+                        break;
+                    case ABS_RY:
+                        axis = JoyAxis::RightY;
+                        break;
+                    case ABS_Z:
+                        axis = JoyAxis::TriggerLeft;
+                        break;
+                    case ABS_RZ:
+                        axis = JoyAxis::TriggerRight;
+                        break;
+                    }
+
+                    if (axis != JoyAxis::Invalid)
+                        sink.axis(joy.id, axis, value, timestamp);
+                }
+                break;
+            }
+            break;
+        }
+    }
+
+    // GODOT end
+}
+
+// The nodes of a device are read together and their reports delivered in
+// the order they happened, always from the node with the oldest report
+// next. Buttons, motion samples and touchpad contacts of a poll so form
+// one consistent frame of the device.
+void LinuxJoystickInput::processJoypads(EventSink &sink)
+{
+    enum Node { Buttons, Motion, Touch, NodeCount };
+    struct Stream {
+        int fd = -1; // -1 once drained for this poll
+        input_event events[EVENT_BATCH_SIZE];
+        int count = 0;
+        int position = 0;
+        bool failed = false;
+    };
+
+    for (size_t i = 0; i < m_joypads.size();) {
+        gamepad& joy = *m_joypads[i];
+
+        Stream streams[NodeCount];
+        streams[Buttons].fd = joy.fd;
+        streams[Motion].fd = joy.motion ? joy.motion->fd : -1;
+        streams[Touch].fd = joy.touch ? joy.touch->fd : -1;
+        int pending = 0;
+
+        // get joypad events, a batch at a time into a fixed buffer
+        auto refill = [&](Node node) {
+            Stream &stream = streams[node];
+            if (stream.fd == -1 || stream.position < stream.count)
+                return;
+            const ssize_t len = read(stream.fd, stream.events, sizeof(stream.events));
+            stream.position = 0;
+            stream.count = len > 0 ? int(len / sizeof(input_event)) : 0;
+            if (!stream.count) {
+                stream.failed = len < 0 && errno != EAGAIN;
+                stream.fd = -1;
+                return;
+            }
+            if (node != Buttons)
+                return;
+            pending += stream.count;
+            Q_TRACE(LinuxJoystickInput_readBatch, joy.id, stream.count);
+            if (joy.capture) {
+                EvdevCapture::Event captured[EVENT_BATCH_SIZE];
+                for (int j = 0; j < stream.count; j++) {
+                    const input_event &event = stream.events[j];
+                    captured[j] = { event.input_event_sec, event.input_event_usec, event.type, event.code, event.value };
+                }
+                joy.capture->write(reinterpret_cast<const char *>(captured), stream.count * sizeof(EvdevCapture::Event));
+                joy.capture->flush();
+            }
+        };
+
+        for (;;) {
+            int next = -1;
+            for (int node = 0; node < NodeCount; node++) {
+                refill(Node(node));
+                const Stream &stream = streams[node];
+                if (stream.position < stream.count
+                    && (next == -1 || eventTime(stream.events[stream.position])
+                                   < eventTime(streams[next].events[streams[next].position]))) {
+                    next = node;
+                }
+            }
+            if (next == -1)
+                break;
+
+            // Up to and including the SYN_REPORT, or the end of the batch
+            Stream &stream = streams[next];
+            int end = stream.position;
+            while (end < stream.count && !(stream.events[end].type == EV_SYN && stream.events[end].code == SYN_REPORT))
+                ++end;
+            end = qMin(end + 1, stream.count);
+            const input_event *events = stream.events + stream.position;
+            const int count = end - stream.position;
+            stream.position = end;
+
+            switch (next) {
+            case Buttons:
+                processJoypadEvents(joy, events, count, sink);
+                break;
+            case Motion:
+                processMotionEvents(*joy.motion, events, count, sink);
+                break;
+            case Touch:
+                processTouchEvents(*joy.touch, events, count, sink);
+                break;
+            }
+        }
+
+        if (streams[Buttons].failed) {
+            closeJoypad(joy.id, sink);
             continue;
         }
+        if (streams[Motion].failed) {
+            forgetDevice(joy.motion->devpath);
+            joy.motion.reset();
+            Q_EMIT pollDescriptorsChanged();
+        }
+        if (streams[Touch].failed) {
+            forgetDevice(joy.touch->devpath);
+            sink.touch(joy.id, nullptr, 0, 0);
+            joy.touch.reset();
+            Q_EMIT pollDescriptorsChanged();
+        }
+
+        if (pending)
+            sink.queueDepth(joy.id, pending);
+        ++i;
+    }
+}
 
-        // GODOT begin
+void LinuxJoystickInput::processMotionEvents(MotionNode &sensors, const input_event *events, int count,
+                                             EventSink &sink)
+{
+    for (int e = 0; e < count; ++e) {
+        const input_event &event = events[e];
 
-        for (const auto& event : events) {
-            // event may be tainted and out of MAX_KEY range, which will cause
-            // joy.key_map[event.code] to crash
-            if (event.code >= MAX_KEY) {
-                qDebug() << "Joypad event code out of range:" << event.code;
+        if (event.type == EV_SYN && event.code == SYN_DROPPED) {
+            sensors.dropped = true;
+            if (sensors.id != -1)
+                sink.eventsDropped(sensors.id);
+            continue;
+        }
+        // The axes read after the drop may belong to any report, the
+        // kernel has the current ones once the next report completes
+        if (sensors.dropped) {
+            if (event.type == EV_SYN && event.code == SYN_REPORT) {
+                sensors.dropped = false;
+                resyncMotionNode(sensors);
+            } else {
                 continue;
             }
+        }
 
-            switch (event.type) {
-            case EV_KEY:
-                input->joyButton(joy.id, (JoyButton)joy.key_map[event.code], event.value);
-                break;
+        if (event.type == EV_ABS && event.code <= ABS_RZ) {
+            sensors.raw[event.code] = event.value;
+            continue;
+        }
+        if (event.type != EV_SYN || event.code != SYN_REPORT || sensors.id == -1)
+            continue;
 
-            case EV_ABS:
-                switch (event.code) {
-                case ABS_HAT0X:
-                    if (event.value != 0) {
-                        if (event.value < 0) {
-                            joy.dpad = HatMask::Left;
-                        } else {
-                            joy.dpad = HatMask::Right;
-                        }
-                    } else {
-                        joy.dpad = HatMask::Center;
-                    }
-                    input->joyHat(i, joy.dpad);
-                    break;
-
-                case ABS_HAT0Y:
-                    if (event.value != 0) {
-                        if (event.value < 0) {
-                            joy.dpad = HatMask::Up;
-                        } else {
-                            joy.dpad = HatMask::Down;
-                        }
-                    } else {
-                        joy.dpad = HatMask::Center;
-                    }
-                    input->joyHat(i, joy.dpad);
-                    break;
+        // Only the axes that changed are reported, the others keep their
+        // last value
+        QUniversalInput::MotionSample sample;
+        sample.timestamp = eventTime(event);
+        sample.acceleration = QVector3D(sensors.raw[ABS_X] * sensors.scale[ABS_X],
+                                        sensors.raw[ABS_Y] * sensors.scale[ABS_Y],
+                                        sensors.raw[ABS_Z] * sensors.scale[ABS_Z]);
+        sample.gyroscope = QVector3D(sensors.raw[ABS_RX] * sensors.scale[ABS_RX],
+                                     sensors.raw[ABS_RY] * sensors.scale[ABS_RY],
+                                     sensors.raw[ABS_RZ] * sensors.scale[ABS_RZ]);
+        sink.motion(sensors.id, sample);
+    }
+}
 
-                default:
-                    if (event.code >= MAX_ABS) {
-                        continue;
-                    }
-                    if (joy.abs_info[event.code]) {
-                        // using the min/max values from the device
-                        auto min = joy.abs_info[event.code]->minimum;
-                        auto max = joy.abs_info[event.code]->maximum;
-
-                        float value = event.value;
-                        value = axisCorrect(value, min, max);
-
-                        JoyAxis axis = JoyAxis::Invalid;
-
-                        switch (event.code) {
-                        case ABS_X:
-                            axis = JoyAxis::LeftX;
-                            break;
-                        case ABS_Y:
-                            axis = JoyAxis::LeftY;
-                            break;
-                        case ABS_RX:
-                            axis = JoyAxis::RightX;
-                            break;
-                        case ABS_RY:
-                            axis = JoyAxis::RightY;
-                            break;
-                        case ABS_Z:
-                            axis = JoyAxis::TriggerLeft;
-                            break;
-                        case ABS_RZ:
-                            axis = JoyAxis::TriggerRight;
-                            break;
-                        }
-
-                        input->joyAxis(joy.id, axis, value);
-                    }
-                    break;
-                }
+// Reads the state of every slot, as the kernel documentation prescribes
+// after SYN_DROPPED
+void LinuxJoystickInput::resyncTouchNode(TouchNode &touch)
+{
+    struct {
+        __u32 code;
+        __s32 values[TOUCH_SLOTS_MAX];
+    } request;
+
+    for (const int code : { ABS_MT_TRACKING_ID, ABS_MT_POSITION_X, ABS_MT_POSITION_Y, ABS_MT_PRESSURE }) {
+        if (code == ABS_MT_PRESSURE && !touch.maximumPressure)
+            continue;
+        request.code = code;
+        if (ioctl(touch.fd, EVIOCGMTSLOTS(sizeof(request)), &request) < 0) {
+            // Without the tracking ids no slot can be trusted
+            if (code == ABS_MT_TRACKING_ID) {
+                for (TouchNode::Slot &slot : touch.slots)
+                    slot.trackingId = -1;
+            }
+            continue;
+        }
+        for (int i = 0; i < touch.slotCount; i++) {
+            TouchNode::Slot &slot = touch.slots[i];
+            switch (code) {
+            case ABS_MT_TRACKING_ID:
+                slot.trackingId = request.values[i];
+                break;
+            case ABS_MT_POSITION_X:
+                slot.x = request.values[i];
+                break;
+            case ABS_MT_POSITION_Y:
+                slot.y = request.values[i];
+                break;
+            case ABS_MT_PRESSURE:
+                slot.pressure = request.values[i];
                 break;
             }
         }
+    }
+
+    input_absinfo absinfo;
+    if (ioctl(touch.fd, EVIOCGABS(ABS_MT_SLOT), &absinfo) >= 0)
+        touch.slot = absinfo.value;
+    touch.changed = true;
+}
+
+static inline float touchCorrect(int value, int min, int max)
+{
+    return max > min ? qBound(0.0f, float(value - min) / (max - min), 1.0f) : 0.0f;
+}
+
+void LinuxJoystickInput::sendTouchFrame(TouchNode &touch, qint64 timestamp, EventSink &sink)
+{
+    QUniversalInput::TouchContact contacts[TOUCH_SLOTS_MAX];
+    int count = 0;
+    for (int i = 0; i < touch.slotCount; i++) {
+        const TouchNode::Slot &slot = touch.slots[i];
+        if (slot.trackingId == -1)
+            continue;
+        QUniversalInput::TouchContact &contact = contacts[count++];
+        contact.id = slot.trackingId;
+        contact.slot = i;
+        contact.position = QVector2D(touchCorrect(slot.x, touch.minimumX, touch.maximumX),
+                                     touchCorrect(slot.y, touch.minimumY, touch.maximumY));
+        contact.pressure = touch.maximumPressure ? touchCorrect(slot.pressure, 0, touch.maximumPressure) : 0.0f;
+    }
+    touch.changed = false;
+    sink.touch(touch.id, contacts, count, timestamp);
+}
+
+// Type B multitouch: ABS_MT_SLOT selects the slot the following events
+// update, a tracking id of -1 lifts the finger of the slot. A frame with
+// every current contact is sent on each SYN_REPORT that changed any.
+void LinuxJoystickInput::processTouchEvents(TouchNode &touch, const input_event *events, int count,
+                                            EventSink &sink)
+{
+    for (int e = 0; e < count; ++e) {
+        const input_event &event = events[e];
+        const qint64 timestamp = eventTime(event);
 
-        if (joy.force_feedback) {
-            uint64_t timestamp = input->getJoyVibrationTimestamp(joy.id);
-            float duration = input->getJoyVibrationDuration(joy.id) * 1000.f;
-            QVector2D strength = input->getJoyVibrationStrength(joy.id);
-            uint64_t currentTimestamp = QDateTime::currentMSecsSinceEpoch();
-            if (currentTimestamp - timestamp <= duration) {
-                if (!joy.vibrating)
-                    joypadVibrationStart(joy, strength.x(), strength.y(), duration, timestamp);
-            } else if (joy.vibrating) {
-                joypadVibrationStop(joy, 0);
+        if (event.type == EV_SYN && event.code == SYN_DROPPED) {
+            touch.dropped = true;
+            sink.eventsDropped(touch.id);
+            continue;
+        }
+        if (touch.dropped) {
+            if (event.type == EV_SYN && event.code == SYN_REPORT) {
+                touch.dropped = false;
+                resyncTouchNode(touch);
+                sendTouchFrame(touch, timestamp, sink);
             }
+            continue;
+        }
+
+        if (event.type == EV_SYN && event.code == SYN_REPORT) {
+            if (touch.changed)
+                sendTouchFrame(touch, timestamp, sink);
+            continue;
         }
+        if (event.type != EV_ABS)
+            continue;
 
-        // GODOT end
+        if (event.code == ABS_MT_SLOT) {
+            touch.slot = event.value;
+            continue;
+        }
+        // Events for slots beyond those we keep are ignored
+        if (touch.slot < 0 || touch.slot >= touch.slotCount)
+            continue;
+        TouchNode::Slot &slot = touch.slots[touch.slot];
+        switch (event.code) {
+        case ABS_MT_TRACKING_ID:
+            slot.trackingId = event.value < 0 ? -1 : event.value;
+            break;
+        case ABS_MT_POSITION_X:
+            slot.x = event.value;
+            break;
+        case ABS_MT_POSITION_Y:
+            slot.y = event.value;
+            break;
+        case ABS_MT_PRESSURE:
+            slot.pressure = event.value;
+            break;
+        default:
+            continue;
+        }
+        touch.changed = true;
     }
 }
 
@@ -421,6 +1098,7 @@ void LinuxJoystickInput::joypadVibrationStart(gamepad &p_joypad, float p_weak_ma
         qWarning() << "Couldn't write to Joypad device.";
 
     p_joypad.ff_effect_id = effect.id;
+    p_joypad.vibrating = true;
 
     // GODOT end
 }
@@ -442,12 +1120,5 @@ void LinuxJoystickInput::joypadVibrationStop(gamepad &p_joypad, uint64_t p_times
     // GODOT end
 }
 
-void LinuxJoystickInput::timerEvent(QTimerEvent *event)
-{
-    Q_UNUSED(event);
-    probeJoypads();
-    processJoypads();
-}
-
 
 QT_END_NAMESPACE
@@ -13,9 +13,12 @@
 #include <QtUniversalInput/private/qjoystickinput_p.h>
 
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
 #include <QtCore/QLibrary>
 #include <QtCore/QThread>
+#include <QtCore/QVarLengthArray>
 
+#include <memory>
 #include <vector>
 
 // for JoypadEvent
@@ -23,7 +26,8 @@
 #include <quniversalinput.h>
 
 struct udev;
-struct input_absinfo;
+struct udev_monitor;
+struct input_event;
 
 QT_BEGIN_NAMESPACE
 
@@ -34,66 +38,163 @@ public:
     LinuxJoystickInput();
     ~LinuxJoystickInput();
 
-    void probeJoypads();
-    void processJoypads();
+    Capabilities capabilities() const override;
+    bool start(EventSink &sink) override;
+    void stop(EventSink &sink) override;
+    QList<qintptr> pollDescriptors() const override;
+    int pollInterval() const override;
+    void poll(EventSink &sink) override;
+    bool setRumble(int device, float weakMagnitude, float strongMagnitude, int durationMs) override;
 
-protected:
-    void timerEvent(QTimerEvent *event) override;
+    void probeJoypads(EventSink &sink);
+    void processJoypads(EventSink &sink);
+    void processMonitor(EventSink &sink);
 
 private:
     enum {
-        JOYPADS_MAX = 16,
         JOY_AXIS_COUNT = 6,
         MIN_JOY_AXIS = 10,
         MAX_JOY_AXIS = 32768,
         MAX_JOY_BUTTONS = 128,
         KEY_EVENT_BUFFER_SIZE = 512,
+        EVENT_BATCH_SIZE = 64,
         MAX_TRIGGER = 1023, // was 255, but xbox one controller max is 1023
+        TOUCH_SLOTS_MAX = QUniversalInput::TouchContactsMax,
 
         // from godot linux_joystick.h
         MAX_ABS = 63,
         MAX_KEY = 767, // Hack because <linux/input.h> can't be included here
     };
 
+    struct MotionNode;
+    struct TouchNode;
+
+    // Per-device state, sized from the capabilities the device reports.
+    // Owns the file descriptor, which is closed when the gamepad is destroyed.
     struct gamepad {
-        int id;
-        bool attached;
-        bool confirmed;
-        int key_map[MAX_KEY];
-        int joy_axis[JOY_AXIS_COUNT];
+        struct AbsAxis {
+            quint16 code;
+            int minimum;
+            int maximum;
+        };
 
-        HatMask dpad;
+        int id = -1;
+        bool confirmed = false;
+        // Key codes of the device buttons, indexed by button number
+        QVarLengthArray<quint16, 32> buttonCodes;
+        QVarLengthArray<AbsAxis, 8> absAxes;
 
-        int fd;
-        QString devpath;
+        HatMask dpad = HatMask::Center;
 
-        input_absinfo *abs_info[MAX_ABS] = {};
+        int fd = -1;
+        QString devpath;
+        // Shared with the other nodes of the same physical device
+        QString parent;
 
-        bool force_feedback;
-        int ff_effect_id;
+        bool force_feedback = false;
+        int ff_effect_id = -1;
         bool vibrating = false;
 
-        gamepad() {
-            id = -1;
-            attached = false;
-            confirmed = false;
-            fd = -1;
-        }
+        // Raw event capture, see evdevcapture.h
+        std::unique_ptr<QFile> capture;
+
+        // The other nodes of the same physical device, read along with it
+        std::unique_ptr<MotionNode> motion;
+        std::unique_ptr<TouchNode> touch;
+
+        gamepad() = default;
+        ~gamepad();
+        Q_DISABLE_COPY_MOVE(gamepad)
+
+        int buttonForCode(int code) const;
+        const AbsAxis *absAxisForCode(int code) const;
+    };
+
+    // The separate node with the accelerometer and gyroscope of a gamepad
+    // (INPUT_PROP_ACCELEROMETER). It is opened whether or not the gamepad
+    // node was found yet, and moves into the gamepad once it is.
+    struct MotionNode {
+        int id = -1; // of the gamepad
+        int fd = -1;
+        QString devpath;
+        QString parent;
+        // Raw value to m/s^2 for ABS_X to ABS_Z and rad/s for ABS_RX to
+        // ABS_RZ, from the resolution the kernel reports
+        float scale[6] = {};
+        int raw[6] = {};
+        // Events up to the next SYN_REPORT are incomplete and skipped
+        bool dropped = false;
+
+        MotionNode() = default;
+        ~MotionNode();
+        Q_DISABLE_COPY_MOVE(MotionNode)
+    };
+
+    // The separate touchpad node of a gamepad, with multitouch slots
+    // (ABS_MT_SLOT). Like the motion node it moves into its gamepad, the
+    // slots are resynchronized from the kernel then and after events were
+    // dropped.
+    struct TouchNode {
+        struct Slot {
+            int trackingId = -1; // -1 for no finger
+            int x = 0;
+            int y = 0;
+            int pressure = 0;
+        };
+
+        int id = -1; // of the gamepad
+        int fd = -1;
+        QString devpath;
+        QString parent;
+        int minimumX = 0;
+        int maximumX = 0;
+        int minimumY = 0;
+        int maximumY = 0;
+        int maximumPressure = 0; // 0 without ABS_MT_PRESSURE
+        int slotCount = 0;
+        int slot = 0; // the slot the next ABS_MT_* events are for
+        bool changed = false;
+        // Events up to the next SYN_REPORT are incomplete and skipped
+        bool dropped = false;
+        Slot slots[TOUCH_SLOTS_MAX];
+
+        TouchNode() = default;
+        ~TouchNode();
+        Q_DISABLE_COPY_MOVE(TouchNode)
     };
 
-    void setupJoypadObject(const QString& name);
+    void setupJoypadObject(const QString& name, EventSink &sink);
+    void setupMotionNode(const QString &device, int fd, const unsigned long *absbit);
+    void setupTouchNode(const QString &device, int fd, const unsigned long *absbit);
+    void linkSiblingNodes();
+    void resyncMotionNode(MotionNode &sensors);
+    void processMotionEvents(MotionNode &sensors, const input_event *events, int count, EventSink &sink);
+    void resyncTouchNode(TouchNode &touch);
+    void processTouchEvents(TouchNode &touch, const input_event *events, int count, EventSink &sink);
+    void sendTouchFrame(TouchNode &touch, qint64 timestamp, EventSink &sink);
+    QString parentDevice(int fd) const;
     void setupJoypadProperties(gamepad* joy);
-    void closeJoypads();
-    void closeJoypad(const char *p_devpath);
-    void closeJoypad(gamepad &p_joypad, int p_id);
+    void processJoypadEvents(gamepad &joy, const input_event *events, int count, EventSink &sink);
+    void closeJoypads(EventSink &sink);
+    void closeJoypad(const char *p_devpath, EventSink &sink);
+    void closeJoypad(int p_id, EventSink &sink);
+    gamepad *joypad(int id) const;
+    void forgetDevice(const QString &devpath);
+    void startCapture(gamepad &joy);
 
     void joypadVibrationStart(gamepad &p_joypad, float p_weak_magnitude, float p_strong_magnitude, float p_duration, uint64_t p_timestamp);
     void joypadVibrationStop(gamepad &p_joypad, uint64_t p_timestamp);
 
     struct udev *m_udev = nullptr;
-    gamepad m_joypads[JOYPADS_MAX]; // joypad joystick gamestick tomatoe potatoe
+    struct udev_monitor *m_monitor = nullptr;
+    // Only the open devices, in no particular order
+    std::vector<std::unique_ptr<gamepad>> m_joypads; // joypad joystick gamestick tomatoe potatoe
+    // Nodes whose gamepad has not shown up, kept open but not read
+    std::vector<std::unique_ptr<MotionNode>> m_motionNodes;
+    std::vector<std::unique_ptr<TouchNode>> m_touchNodes;
     std::vector<QString> m_attached_devices;
     QElapsedTimer m_elapsedTimer;
+    QString m_captureDir;
 };
 
 QT_END_NAMESPACE
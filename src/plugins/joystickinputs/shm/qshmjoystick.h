@@ -0,0 +1,185 @@
+/* Copyright (C) 2024 The Qt Company Ltd.
+ * SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+ */
+
+#ifndef QSHMJOYSTICK_H
+#define QSHMJOYSTICK_H
+
+/*
+ * Publishing side of the "shm" joystick backend, usable from C and C++.
+ *
+ * A publisher creates a POSIX shared memory segment holding a ring of state
+ * frames per device. The backend maps it read only and picks up the frames
+ * on every poll, so neither side makes a system call per frame.
+ *
+ * Each device must have a single publishing thread. Frames are written
+ * seqlock style: the sequence of a frame is cleared, the frame is written,
+ * and the sequence is set to its ring index + 1. A reader that finds another
+ * sequence before or after copying a frame lost it to the publisher lapping
+ * the ring.
+ *
+ * Buttons and axes use the JoyButton and JoyAxis numbering and go through
+ * the device mapping of the guid given on connect like events of any other
+ * backend.
+ *
+ * A segment has QSHMJOY_MAX_DEVICES slots. This caps the devices of one
+ * publisher, not the ids they get: the backend allocates those like any
+ * other backend. More slots change the segment layout and need a new
+ * QSHMJOY_VERSION.
+ */
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define QSHMJOY_MAGIC 0x4a534851u /* "QHSJ" */
+#define QSHMJOY_VERSION 1u
+#define QSHMJOY_MAX_DEVICES 16
+#define QSHMJOY_RING_SIZE 256
+#define QSHMJOY_AXES 6
+#define QSHMJOY_DEFAULT_NAME "/qtuniversalinput"
+
+typedef struct QShmJoyFrame {
+    uint64_t sequence;
+    int64_t timestamp;        /* CLOCK_MONOTONIC nanoseconds, 0 if not known */
+    uint64_t buttons;         /* bit n set while JoyButton n is pressed */
+    float axes[QSHMJOY_AXES]; /* -1 to 1, triggers 0 to 1 */
+    uint32_t hat;             /* HatMask */
+    uint32_t reserved;
+} QShmJoyFrame;
+
+typedef struct QShmJoyDevice {
+    /* Bit 0 is set while connected, the rest counts connects and disconnects */
+    uint32_t state;
+    uint32_t reserved;
+    char name[64];
+    char guid[40];
+    /* Frames published before the last connect, and in total */
+    uint64_t connectIndex;
+    uint64_t writeIndex;
+    QShmJoyFrame frames[QSHMJOY_RING_SIZE];
+} QShmJoyDevice;
+
+typedef struct QShmJoySegment {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t deviceCount;
+    uint32_t ringSize;
+    QShmJoyDevice devices[QSHMJOY_MAX_DEVICES];
+} QShmJoySegment;
+
+static inline int64_t qshmjoy_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+/* Creates or takes over the segment, with all devices disconnected.
+ * Returns NULL on failure, with errno set. */
+static inline QShmJoySegment *qshmjoy_create(const char *name)
+{
+    int fd = shm_open(name, O_CREAT | O_RDWR, 0600);
+    if (fd == -1)
+        return NULL;
+    if (ftruncate(fd, sizeof(QShmJoySegment)) == -1) {
+        close(fd);
+        return NULL;
+    }
+    void *data = mmap(NULL, sizeof(QShmJoySegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return NULL;
+
+    QShmJoySegment *segment = (QShmJoySegment *)data;
+    __atomic_store_n(&segment->magic, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    for (int i = 0; i < QSHMJOY_MAX_DEVICES; i++) {
+        QShmJoyDevice *device = &segment->devices[i];
+        /* Keep counting, so that readers notice the devices went away */
+        const uint32_t state = __atomic_load_n(&device->state, __ATOMIC_RELAXED);
+        __atomic_store_n(&device->state, (state | 1u) + 1u, __ATOMIC_RELEASE);
+    }
+    segment->version = QSHMJOY_VERSION;
+    segment->deviceCount = QSHMJOY_MAX_DEVICES;
+    segment->ringSize = QSHMJOY_RING_SIZE;
+    __atomic_store_n(&segment->magic, QSHMJOY_MAGIC, __ATOMIC_RELEASE);
+    return segment;
+}
+
+/* Unmaps the segment. The devices stay as they are until the segment is
+ * taken over or removed with qshmjoy_unlink(). */
+static inline void qshmjoy_close(QShmJoySegment *segment)
+{
+    munmap(segment, sizeof(QShmJoySegment));
+}
+
+static inline int qshmjoy_unlink(const char *name)
+{
+    return shm_unlink(name);
+}
+
+/* Returns 0 on success, -1 if the device index is out of range */
+static inline int qshmjoy_connect(QShmJoySegment *segment, int device, const char *name, const char *guid)
+{
+    if (device < 0 || device >= QSHMJOY_MAX_DEVICES)
+        return -1;
+
+    QShmJoyDevice *d = &segment->devices[device];
+    uint32_t state = __atomic_load_n(&d->state, __ATOMIC_RELAXED);
+    if (state & 1u)
+        __atomic_store_n(&d->state, ++state, __ATOMIC_RELEASE);
+
+    strncpy(d->name, name ? name : "", sizeof(d->name) - 1);
+    d->name[sizeof(d->name) - 1] = 0;
+    strncpy(d->guid, guid ? guid : "", sizeof(d->guid) - 1);
+    d->guid[sizeof(d->guid) - 1] = 0;
+    __atomic_store_n(&d->connectIndex, __atomic_load_n(&d->writeIndex, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    __atomic_store_n(&d->state, state + 1u, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static inline void qshmjoy_disconnect(QShmJoySegment *segment, int device)
+{
+    if (device < 0 || device >= QSHMJOY_MAX_DEVICES)
+        return;
+
+    QShmJoyDevice *d = &segment->devices[device];
+    const uint32_t state = __atomic_load_n(&d->state, __ATOMIC_RELAXED);
+    if (state & 1u)
+        __atomic_store_n(&d->state, state + 1u, __ATOMIC_RELEASE);
+}
+
+/* The sequence of the frame passed in is ignored */
+static inline void qshmjoy_publish(QShmJoySegment *segment, int device, const QShmJoyFrame *frame)
+{
+    if (device < 0 || device >= QSHMJOY_MAX_DEVICES)
+        return;
+
+    QShmJoyDevice *d = &segment->devices[device];
+    const uint64_t index = __atomic_load_n(&d->writeIndex, __ATOMIC_RELAXED);
+    QShmJoyFrame *slot = &d->frames[index % QSHMJOY_RING_SIZE];
+
+    __atomic_store_n(&slot->sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    slot->timestamp = frame->timestamp;
+    slot->buttons = frame->buttons;
+    memcpy(slot->axes, frame->axes, sizeof(slot->axes));
+    slot->hat = frame->hat;
+    __atomic_store_n(&slot->sequence, index + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&d->writeIndex, index + 1, __ATOMIC_RELEASE);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QSHMJOYSTICK_H */
@@ -0,0 +1,215 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "shmjoystickinput.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/qalgorithms.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+using namespace Qt::Literals::StringLiterals;
+
+QT_BEGIN_NAMESPACE
+
+// Milliseconds between attempts to open a segment that is not published yet
+static constexpr int RetryInterval = 1000;
+
+ShmJoystickInput::ShmJoystickInput()
+    : m_name(qEnvironmentVariableIsSet("QT_UNIVERSALINPUT_SHM") ? qgetenv("QT_UNIVERSALINPUT_SHM")
+                                                                  : QByteArray(QSHMJOY_DEFAULT_NAME))
+{
+    bool ok = false;
+    const int interval = qEnvironmentVariableIntValue("QT_UNIVERSALINPUT_SHM_INTERVAL", &ok);
+    if (ok && interval >= 0)
+        m_interval = interval;
+}
+
+ShmJoystickInput::~ShmJoystickInput()
+{
+    if (m_segment)
+        munmap(const_cast<QShmJoySegment *>(m_segment), sizeof(QShmJoySegment));
+}
+
+QJoystickInput::Capabilities ShmJoystickInput::capabilities() const
+{
+    return PollDriven | Hotplug | DeviceTimestamps;
+}
+
+bool ShmJoystickInput::start(EventSink &sink)
+{
+    // The publisher may come up later, poll() keeps trying
+    if (openSegment())
+        poll(sink);
+    return true;
+}
+
+void ShmJoystickInput::stop(EventSink &sink)
+{
+    closeSegment(sink);
+}
+
+// Without a segment there is nothing to read, only the next attempt to open
+// it is due
+int ShmJoystickInput::pollInterval() const
+{
+    return m_segment ? m_interval : RetryInterval;
+}
+
+bool ShmJoystickInput::openSegment()
+{
+    m_retry.setRemainingTime(RetryInterval);
+
+    const int fd = shm_open(m_name.constData(), O_RDONLY, 0);
+    if (fd == -1)
+        return false;
+
+    struct stat info;
+    void *data = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size >= qint64(sizeof(QShmJoySegment)))
+        data = mmap(nullptr, sizeof(QShmJoySegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    const auto segment = static_cast<const QShmJoySegment *>(data);
+    if (__atomic_load_n(&segment->magic, __ATOMIC_ACQUIRE) != QSHMJOY_MAGIC
+        || segment->version != QSHMJOY_VERSION || segment->ringSize != QSHMJOY_RING_SIZE
+        || segment->deviceCount > QSHMJOY_MAX_DEVICES) {
+        qWarning() << "Not a supported joystick segment:" << m_name;
+        munmap(data, sizeof(QShmJoySegment));
+        return false;
+    }
+
+    m_segment = segment;
+    return true;
+}
+
+void ShmJoystickInput::closeSegment(EventSink &sink)
+{
+    for (int i = 0; i < QSHMJOY_MAX_DEVICES; i++)
+        updateConnection(i, 0, sink);
+
+    if (m_segment)
+        munmap(const_cast<QShmJoySegment *>(m_segment), sizeof(QShmJoySegment));
+    m_segment = nullptr;
+}
+
+void ShmJoystickInput::updateConnection(int index, quint32 state, EventSink &sink)
+{
+    Device &device = m_devices[index];
+    if (device.id != -1) {
+        sink.connectionChanged(device.id, false, QString(), QString(), QString());
+        device.id = -1;
+    }
+    device = Device();
+    device.state = state;
+
+    if (!(state & 1u))
+        return;
+
+    const QShmJoyDevice &shared = m_segment->devices[index];
+    char name[sizeof(shared.name)];
+    char guid[sizeof(shared.guid)];
+    memcpy(name, shared.name, sizeof(name));
+    memcpy(guid, shared.guid, sizeof(guid));
+    device.readIndex = __atomic_load_n(&shared.connectIndex, __ATOMIC_RELAXED);
+    // Reconnected while we were copying, pick it up on the next poll
+    if (__atomic_load_n(&shared.state, __ATOMIC_ACQUIRE) != state) {
+        device.state = 0;
+        return;
+    }
+    name[sizeof(name) - 1] = 0;
+    guid[sizeof(guid) - 1] = 0;
+
+    const int id = sink.allocateDevice();
+    if (id == -1) {
+        qWarning() << "Could not find unused joypad";
+        return;
+    }
+    const QString physicalId = u"shm:%1:%2"_s.arg(QString::fromLocal8Bit(m_name)).arg(index);
+    if (sink.connectionChanged(id, true, QString::fromUtf8(name), QString::fromLatin1(guid), physicalId))
+        device.id = id;
+}
+
+void ShmJoystickInput::poll(EventSink &sink)
+{
+    // A publisher that went away may have removed the segment, and its
+    // successor created a new one. Follow it while nothing is connected.
+    if (m_segment && m_retry.hasExpired()) {
+        const bool idle = std::all_of(std::begin(m_devices), std::end(m_devices),
+                                      [](const Device &device) { return device.id == -1; });
+        if (idle)
+            closeSegment(sink);
+        else
+            m_retry.setRemainingTime(RetryInterval);
+    }
+
+    if (!m_segment) {
+        if (!m_retry.hasExpired() || !openSegment())
+            return;
+    }
+
+    // Being taken over by a new publisher
+    if (__atomic_load_n(&m_segment->magic, __ATOMIC_ACQUIRE) != QSHMJOY_MAGIC)
+        return;
+
+    for (quint32 i = 0; i < m_segment->deviceCount; i++) {
+        const QShmJoyDevice &shared = m_segment->devices[i];
+        Device &device = m_devices[i];
+
+        const quint32 state = __atomic_load_n(&shared.state, __ATOMIC_ACQUIRE);
+        if (state != device.state)
+            updateConnection(int(i), state, sink);
+        if (device.id == -1)
+            continue;
+
+        const quint64 end = __atomic_load_n(&shared.writeIndex, __ATOMIC_ACQUIRE);
+        if (end <= device.readIndex)
+            continue;
+        if (end - device.readIndex > QSHMJOY_RING_SIZE) {
+            sink.eventsDropped(device.id);
+            device.readIndex = end - QSHMJOY_RING_SIZE;
+        }
+        sink.queueDepth(device.id, int(end - device.readIndex));
+
+        for (; device.readIndex < end; device.readIndex++) {
+            const QShmJoyFrame &slot = shared.frames[device.readIndex % QSHMJOY_RING_SIZE];
+            const quint64 sequence = __atomic_load_n(&slot.sequence, __ATOMIC_ACQUIRE);
+            QShmJoyFrame frame;
+            memcpy(&frame, &slot, sizeof(frame));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            // Overwritten by the publisher lapping the ring
+            if (sequence != device.readIndex + 1 || __atomic_load_n(&slot.sequence, __ATOMIC_RELAXED) != sequence) {
+                sink.eventsDropped(device.id);
+                continue;
+            }
+            deliver(device, frame, sink);
+        }
+    }
+}
+
+void ShmJoystickInput::deliver(Device &device, const QShmJoyFrame &frame, EventSink &sink)
+{
+    for (quint64 changed = frame.buttons ^ device.buttons; changed; changed &= changed - 1) {
+        const int button = qCountTrailingZeroBits(changed);
+        sink.button(device.id, JoyButton(button), frame.buttons & (quint64(1) << button), frame.timestamp);
+    }
+    device.buttons = frame.buttons;
+
+    for (int axis = 0; axis < QSHMJOY_AXES; axis++) {
+        if (frame.axes[axis] != device.axes[axis]) {
+            device.axes[axis] = frame.axes[axis];
+            sink.axis(device.id, JoyAxis(axis), frame.axes[axis], frame.timestamp);
+        }
+    }
+
+    if (frame.hat != device.hat) {
+        device.hat = frame.hat;
+        sink.hat(device.id, HatMask(frame.hat), frame.timestamp);
+    }
+}
+
+QT_END_NAMESPACE
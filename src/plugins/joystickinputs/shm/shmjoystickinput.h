@@ -0,0 +1,57 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef SHMJOYSTICKINPUT_H
+#define SHMJOYSTICKINPUT_H
+
+#include <QtUniversalInput/private/qjoystickinput_p.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDeadlineTimer>
+
+#include "qshmjoystick.h"
+
+QT_BEGIN_NAMESPACE
+
+// Presents the devices published to a shared memory segment, see
+// qshmjoystick.h. The segment is named by QT_UNIVERSALINPUT_SHM and polled
+// every QT_UNIVERSALINPUT_SHM_INTERVAL milliseconds, 1 by default.
+class ShmJoystickInput : public QJoystickInput
+{
+    Q_OBJECT
+public:
+    ShmJoystickInput();
+    ~ShmJoystickInput();
+
+    Capabilities capabilities() const override;
+    bool start(EventSink &sink) override;
+    void stop(EventSink &sink) override;
+    int pollInterval() const override;
+    void poll(EventSink &sink) override;
+
+private:
+    struct Device {
+        quint32 state = 0;
+        int id = -1;
+        quint64 readIndex = 0;
+        // Last state delivered, frames are reported as changes to it
+        quint64 buttons = 0;
+        float axes[QSHMJOY_AXES] = {};
+        quint32 hat = 0;
+    };
+
+    bool openSegment();
+    void closeSegment(EventSink &sink);
+    void updateConnection(int index, quint32 state, EventSink &sink);
+    void deliver(Device &device, const QShmJoyFrame &frame, EventSink &sink);
+
+    QByteArray m_name;
+    int m_interval = 1;
+    const QShmJoySegment *m_segment = nullptr;
+    QDeadlineTimer m_retry;
+    Device m_devices[QSHMJOY_MAX_DEVICES];
+};
+
+QT_END_NAMESPACE
+
+#endif // SHMJOYSTICKINPUT_H
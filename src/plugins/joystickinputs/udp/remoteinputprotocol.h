@@ -0,0 +1,201 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef REMOTEINPUTPROTOCOL_H
+#define REMOTEINPUTPROTOCOL_H
+
+#include <QtUniversalInput/private/qinputrecording_p.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QVarLengthArray>
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+// Datagrams sent to the "udp" joystick backend, one pad per datagram.
+//
+//   magic     "QR"
+//   version   1 byte
+//   flags     1 byte, PacketFlags
+//   pad       1 byte, index of the pad on the sender
+//   count     1 byte, number of frames
+//   sequence  uint32, sequence number of the newest frame
+//   timestamp int64, sender clock of the newest frame in nanoseconds
+//   if Hello: name and guid, as in QInputRecording
+//   frames, newest first
+//
+// Each frame holds the complete pad state, but only the fields that differ
+// from the frame before it in the datagram are written: a mask byte, for
+// all but the first frame the microseconds it is older than the one
+// before, then the buttons (varint), changed axes (int16) and the hat
+// (1 byte). The first frame is compared to the idle state.
+//
+// Frames other than the first repeat what earlier datagrams carried, so
+// that a lost datagram is recovered from the next one. Integers are little
+// endian, axes are quantised as in QInputRecording.
+namespace RemoteInput {
+
+constexpr char Magic[2] = { 'Q', 'R' };
+constexpr quint8 Version = 1;
+constexpr quint16 DefaultPort = 47320;
+constexpr int Axes = 6;
+constexpr int MaxFrames = 8;
+constexpr int MaxPads = 256; // the pad index is a byte
+constexpr int HeaderSize = 18;
+
+enum PacketFlag : quint8 {
+    Hello = 0x1, // carries the name and guid of the pad
+    Bye = 0x2,   // the pad went away
+};
+
+enum FieldMask : quint8 {
+    ButtonsField = 0x1,
+    AxisFields = 0x7e, // 0x2 << axis
+    HatField = 0x80,
+};
+
+struct Frame {
+    quint32 sequence = 0;
+    qint64 timestamp = 0;
+    quint64 buttons = 0;
+    float axes[Axes] = {};
+    quint8 hat = 0;
+};
+
+struct Packet {
+    quint8 flags = 0;
+    quint8 pad = 0;
+    QString name;
+    QString guid;
+    QVarLengthArray<Frame, MaxFrames> frames; // newest first
+};
+
+inline qint16 quantiseAxis(float value)
+{
+    return qint16(qRound(qBound(-1.0f, value, 1.0f) * 32767.0f));
+}
+
+inline void appendInt(QByteArray &out, quint64 value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+        out.append(char((value >> (8 * i)) & 0xff));
+}
+
+inline quint64 readInt(const uchar *pos, int bytes)
+{
+    quint64 value = 0;
+    for (int i = 0; i < bytes; i++)
+        value |= quint64(pos[i]) << (8 * i);
+    return value;
+}
+
+inline QByteArray encode(const Packet &packet)
+{
+    using namespace QInputRecording;
+
+    QByteArray out;
+    out.reserve(64);
+    out.append(Magic, sizeof(Magic));
+    out.append(char(Version));
+    out.append(char(packet.flags));
+    out.append(char(packet.pad));
+    out.append(char(packet.frames.size()));
+    const Frame newest = packet.frames.isEmpty() ? Frame() : packet.frames.first();
+    appendInt(out, newest.sequence, 4);
+    appendInt(out, quint64(newest.timestamp), 8);
+
+    if (packet.flags & Hello) {
+        appendString(out, packet.name);
+        appendString(out, packet.guid);
+    }
+
+    Frame previous;
+    previous.timestamp = newest.timestamp;
+    for (const Frame &frame : packet.frames) {
+        quint8 mask = 0;
+        if (frame.buttons != previous.buttons)
+            mask |= ButtonsField;
+        for (int axis = 0; axis < Axes; axis++) {
+            if (quantiseAxis(frame.axes[axis]) != quantiseAxis(previous.axes[axis]))
+                mask |= quint8(0x2 << axis);
+        }
+        if (frame.hat != previous.hat)
+            mask |= HatField;
+
+        out.append(char(mask));
+        if (&frame != &packet.frames.first())
+            appendVarint(out, quint64(qMax<qint64>(0, previous.timestamp - frame.timestamp) / 1000));
+        if (mask & ButtonsField)
+            appendVarint(out, frame.buttons);
+        for (int axis = 0; axis < Axes; axis++) {
+            if (mask & (0x2 << axis))
+                appendAxisValue(out, frame.axes[axis]);
+        }
+        if (mask & HatField)
+            out.append(char(frame.hat));
+        previous = frame;
+    }
+    return out;
+}
+
+inline bool decode(const QByteArray &data, Packet *packet)
+{
+    using namespace QInputRecording;
+
+    const uchar *pos = reinterpret_cast<const uchar *>(data.constData());
+    const uchar *end = pos + data.size();
+    if (data.size() < HeaderSize || memcmp(pos, Magic, sizeof(Magic)) != 0 || pos[2] != Version)
+        return false;
+
+    packet->flags = pos[3];
+    packet->pad = pos[4];
+    const int count = pos[5];
+    Frame previous;
+    previous.sequence = quint32(readInt(pos + 6, 4));
+    previous.timestamp = qint64(readInt(pos + 10, 8));
+    pos += HeaderSize;
+    if (count > MaxFrames)
+        return false;
+
+    if (packet->flags & Hello) {
+        if (!readString(pos, end, &packet->name) || !readString(pos, end, &packet->guid))
+            return false;
+    }
+
+    packet->frames.clear();
+    for (int i = 0; i < count; i++) {
+        if (pos == end)
+            return false;
+        const quint8 mask = *pos++;
+        Frame frame = previous;
+        if (i > 0) {
+            quint64 age = 0;
+            if (!readVarint(pos, end, &age))
+                return false;
+            frame.sequence = previous.sequence - 1;
+            frame.timestamp = previous.timestamp - qint64(age) * 1000;
+        }
+        if ((mask & ButtonsField) && !readVarint(pos, end, &frame.buttons))
+            return false;
+        for (int axis = 0; axis < Axes; axis++) {
+            if ((mask & (0x2 << axis)) && !readAxisValue(pos, end, &frame.axes[axis]))
+                return false;
+        }
+        if (mask & HatField) {
+            if (pos == end)
+                return false;
+            frame.hat = *pos++;
+        }
+        packet->frames.append(frame);
+        previous = frame;
+    }
+    return true;
+}
+
+} // namespace RemoteInput
+
+QT_END_NAMESPACE
+
+#endif // REMOTEINPUTPROTOCOL_H
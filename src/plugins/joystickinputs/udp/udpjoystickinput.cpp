@@ -0,0 +1,244 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "udpjoystickinput.h"
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QDebug>
+#include <QtCore/qalgorithms.h>
+#include <QtNetwork/QNetworkDatagram>
+#include <QtNetwork/QUdpSocket>
+
+using namespace Qt::Literals::StringLiterals;
+
+QT_BEGIN_NAMESPACE
+
+using namespace RemoteInput;
+
+// Pads are dropped when their sender has been silent this long. Senders
+// repeat the current state several times a second, even when idle.
+static constexpr qint64 PadTimeout = 1000 * 1000 * 1000;
+// Upper bound of the adaptive playout delay
+static constexpr qint64 MaxPlayoutDelay = 50 * 1000 * 1000;
+// Frames waiting for playout before the oldest are played regardless
+static constexpr int MaxPendingFrames = 64;
+
+UdpJoystickInput::UdpJoystickInput()
+{
+    // "port", "address:port" or "[IPv6 address]:port"
+    const QString listen = qEnvironmentVariable("QT_UNIVERSALINPUT_UDP");
+    if (!listen.isEmpty()) {
+        QHostAddress address = m_address;
+        const qsizetype colon = listen.lastIndexOf(u':');
+        QString port = listen;
+        if (colon != -1) {
+            QString host = listen.left(colon);
+            if (host.startsWith(u'[') && host.endsWith(u']'))
+                host = host.mid(1).chopped(1);
+            address = QHostAddress(host);
+            port = listen.mid(colon + 1);
+        }
+        const int number = port.toInt();
+        if (number <= 0 || number >= 65536 || address.isNull()) {
+            // Nothing of it is used, rather than guessing which part was meant
+            qWarning() << "Invalid QT_UNIVERSALINPUT_UDP" << listen << "- listening on" << m_address << m_port;
+        } else if (!address.isLoopback() && !qEnvironmentVariableIsSet("QT_UNIVERSALINPUT_UDP_REMOTE")) {
+            // Anyone who can reach the port could drive the application
+            qWarning() << "Not listening for remote input on" << address
+                       << "without QT_UNIVERSALINPUT_UDP_REMOTE, listening on" << m_address << "instead";
+            m_port = quint16(number);
+        } else {
+            m_address = address;
+            m_port = quint16(number);
+        }
+    }
+
+    bool ok = false;
+    const int delay = qEnvironmentVariableIntValue("QT_UNIVERSALINPUT_UDP_DELAY", &ok);
+    if (ok && delay >= 0)
+        m_fixedDelay = qint64(delay) * 1000 * 1000;
+}
+
+UdpJoystickInput::~UdpJoystickInput()
+{
+}
+
+QJoystickInput::Capabilities UdpJoystickInput::capabilities() const
+{
+    return PollDriven | Hotplug | DeviceTimestamps;
+}
+
+bool UdpJoystickInput::start(EventSink &sink)
+{
+    Q_UNUSED(sink);
+    // A child, so that it moves to the input thread with us
+    m_socket = new QUdpSocket(this);
+    if (!m_socket->bind(m_address, m_port)) {
+        qWarning() << "Could not listen for remote input on" << m_address << m_port << m_socket->errorString();
+        delete m_socket;
+        m_socket = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void UdpJoystickInput::stop(EventSink &sink)
+{
+    for (Pad &pad : m_pads)
+        disconnectPad(pad, sink);
+    m_pads.clear();
+
+    delete m_socket;
+    m_socket = nullptr;
+}
+
+// Frames are due at arbitrary times, polling on a short interval releases
+// them close to their playout time
+int UdpJoystickInput::pollInterval() const
+{
+    return 1;
+}
+
+void UdpJoystickInput::poll(EventSink &sink)
+{
+    const qint64 now = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+    receive(sink, now);
+
+    for (auto it = m_pads.begin(); it != m_pads.end();) {
+        Pad &pad = it.value();
+        if (now - pad.lastArrival > PadTimeout) {
+            disconnectPad(pad, sink);
+            it = m_pads.erase(it);
+            continue;
+        }
+        playOut(pad, sink, now);
+        ++it;
+    }
+}
+
+void UdpJoystickInput::receive(EventSink &sink, qint64 now)
+{
+    if (!m_socket)
+        return;
+
+    Packet packet;
+    while (m_socket->hasPendingDatagrams()) {
+        const QNetworkDatagram datagram = m_socket->receiveDatagram();
+        if (!decode(datagram.data(), &packet))
+            continue;
+        const QString key = u"udp:%1:%2:%3"_s.arg(datagram.senderAddress().toString())
+                                    .arg(datagram.senderPort())
+                                    .arg(int(packet.pad));
+        handlePacket(packet, key, sink, now);
+    }
+}
+
+void UdpJoystickInput::handlePacket(const Packet &packet, const QString &key, EventSink &sink, qint64 now)
+{
+    if (packet.flags & Bye) {
+        const auto it = m_pads.find(key);
+        if (it != m_pads.end()) {
+            disconnectPad(*it, sink);
+            m_pads.erase(it);
+        }
+        return;
+    }
+    if (packet.frames.isEmpty())
+        return;
+
+    Pad &pad = m_pads[key];
+    if (pad.id == -1) {
+        // Pads are announced with a Hello, frames that arrive before it
+        // have nobody to go to
+        if (!(packet.flags & Hello))
+            return;
+        const int id = sink.allocateDevice();
+        if (id == -1) {
+            qWarning() << "Could not find unused joypad";
+            m_pads.remove(key);
+            return;
+        }
+        if (!sink.connectionChanged(id, true, packet.name, packet.guid, key)) {
+            m_pads.remove(key);
+            return;
+        }
+        pad.id = id;
+    }
+
+    // The transit time of the newest frame, including the difference
+    // between the clocks. The smallest seen approximates the fixed part,
+    // what exceeds it is jitter.
+    const qint64 transit = now - packet.frames.first().timestamp;
+    if (!pad.lastArrival || transit < pad.offset)
+        pad.offset = transit;
+    pad.jitter += ((transit - pad.offset) - pad.jitter) / 16.0f;
+    pad.lastArrival = now;
+
+    for (const Frame &frame : packet.frames) {
+        // Redundant copies of frames already played or queued
+        if (pad.started && qint32(frame.sequence - pad.lastSequence) <= 0)
+            continue;
+        pad.pending.insert(frame.sequence, frame);
+    }
+}
+
+qint64 UdpJoystickInput::playoutDelay(const Pad &pad) const
+{
+    if (m_fixedDelay >= 0)
+        return m_fixedDelay;
+    return qMin(qint64(3.0f * pad.jitter), MaxPlayoutDelay);
+}
+
+void UdpJoystickInput::playOut(Pad &pad, EventSink &sink, qint64 now)
+{
+    if (pad.pending.isEmpty())
+        return;
+
+    sink.queueDepth(pad.id, int(pad.pending.size()));
+    const qint64 delay = playoutDelay(pad);
+    while (!pad.pending.isEmpty()) {
+        const auto it = pad.pending.begin();
+        if (it->timestamp + pad.offset + delay > now && pad.pending.size() <= MaxPendingFrames)
+            break;
+
+        // Frames neither the datagram nor its redundant copies arrived for
+        if (pad.started && it.key() != pad.lastSequence + 1)
+            sink.eventsDropped(pad.id);
+
+        deliver(pad, *it, sink);
+        pad.lastSequence = it.key();
+        pad.started = true;
+        pad.pending.erase(it);
+    }
+}
+
+void UdpJoystickInput::deliver(Pad &pad, const Frame &frame, EventSink &sink)
+{
+    // When the frame would have arrived without jitter, on our clock
+    const qint64 timestamp = frame.timestamp + pad.offset;
+
+    for (quint64 changed = frame.buttons ^ pad.state.buttons; changed; changed &= changed - 1) {
+        const int button = qCountTrailingZeroBits(changed);
+        if (button < int(JoyButton::MAX))
+            sink.button(pad.id, JoyButton(button), frame.buttons & (quint64(1) << button), timestamp);
+    }
+
+    for (int axis = 0; axis < Axes; axis++) {
+        if (frame.axes[axis] != pad.state.axes[axis])
+            sink.axis(pad.id, JoyAxis(axis), frame.axes[axis], timestamp);
+    }
+
+    if (frame.hat != pad.state.hat)
+        sink.hat(pad.id, HatMask(frame.hat), timestamp);
+
+    pad.state = frame;
+}
+
+void UdpJoystickInput::disconnectPad(Pad &pad, EventSink &sink)
+{
+    if (pad.id != -1)
+        sink.connectionChanged(pad.id, false, QString(), QString(), QString());
+    pad.id = -1;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,71 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef UDPJOYSTICKINPUT_H
+#define UDPJOYSTICKINPUT_H
+
+#include <QtUniversalInput/private/qjoystickinput_p.h>
+
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtNetwork/QHostAddress>
+
+#include "remoteinputprotocol.h"
+
+QT_BEGIN_NAMESPACE
+
+class QUdpSocket;
+
+// Presents pads streamed by remote senders, see remoteinputprotocol.h.
+//
+// QT_UNIVERSALINPUT_UDP sets the address and port to listen on, for
+// instance "127.0.0.1:47320" or just a port. Other than loopback addresses
+// also need QT_UNIVERSALINPUT_UDP_REMOTE to be set, by default only local
+// senders are heard. Frames are played out after a delay that absorbs the
+// network jitter seen so far, or after a fixed QT_UNIVERSALINPUT_UDP_DELAY
+// milliseconds.
+class UdpJoystickInput : public QJoystickInput
+{
+    Q_OBJECT
+public:
+    UdpJoystickInput();
+    ~UdpJoystickInput();
+
+    Capabilities capabilities() const override;
+    bool start(EventSink &sink) override;
+    void stop(EventSink &sink) override;
+    int pollInterval() const override;
+    void poll(EventSink &sink) override;
+
+private:
+    struct Pad {
+        int id = -1;
+        bool started = false;
+        quint32 lastSequence = 0;
+        qint64 lastArrival = 0;
+        // Sender clock to ours, the smallest transit seen, and the mean
+        // deviation from it in nanoseconds
+        qint64 offset = 0;
+        float jitter = 0.0f;
+        // Received but not played out yet, by sequence
+        QMap<quint32, RemoteInput::Frame> pending;
+        RemoteInput::Frame state;
+    };
+
+    void receive(EventSink &sink, qint64 now);
+    void handlePacket(const RemoteInput::Packet &packet, const QString &key, EventSink &sink, qint64 now);
+    void playOut(Pad &pad, EventSink &sink, qint64 now);
+    void deliver(Pad &pad, const RemoteInput::Frame &frame, EventSink &sink);
+    void disconnectPad(Pad &pad, EventSink &sink);
+    qint64 playoutDelay(const Pad &pad) const;
+
+    QHostAddress m_address = QHostAddress::LocalHost;
+    quint16 m_port = RemoteInput::DefaultPort;
+    qint64 m_fixedDelay = -1;
+    QUdpSocket *m_socket = nullptr;
+    QHash<QString, Pad> m_pads;
+};
+
+QT_END_NAMESPACE
+
+#endif // UDPJOYSTICKINPUT_H
@@ -0,0 +1,17 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "udpjoystickinputplugin.h"
+#include "udpjoystickinput.h"
+
+QT_BEGIN_NAMESPACE
+
+QJoystickInput *UdpJoystickInputPlugin::create(const QString &key, const QStringList &paramList)
+{
+    Q_UNUSED(paramList);
+    if (key == QLatin1String("udp"))
+        return new UdpJoystickInput();
+    return nullptr;
+}
+
+QT_END_NAMESPACE
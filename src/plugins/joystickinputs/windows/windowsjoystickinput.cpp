@@ -50,9 +50,6 @@ WindowsJoystickInput::WindowsJoystickInput()
 
     load_xinput();
 
-    for (int i = 0; i < JOYPADS_MAX; i++)
-        attached_joypads[i] = false;
-
     HRESULT result = DirectInput8Create(GetModuleHandle(nullptr), DIRECTINPUT_VERSION, IID_IDirectInput8, (void **)&dinput, nullptr);
     if (result == DI_OK) {
         probeJoypads();
@@ -91,33 +88,34 @@ void WindowsJoystickInput::probeJoypads()
 
         dwResult = xinput_get_state(i, &x_joypads[i].state);
         if (dwResult == ERROR_SUCCESS) {
-            int id = input->getUnusedJoyId();
-            if (id != -1 && !x_joypads[i].attached) {
+            if (x_joypads[i].attached)
+                continue;
+            // Reserved until the device disconnects
+            const int id = input->allocateJoyId();
+            if (id != -1) {
                 x_joypads[i].attached = true;
                 x_joypads[i].id = id;
                 x_joypads[i].ff_timestamp = 0;
                 x_joypads[i].ff_end_timestamp = 0;
                 x_joypads[i].vibrating = false;
-                attached_joypads[id] = true;
                 input->updateJoyConnection(id, true, "XInput Gamepad", "__XINPUT_DEVICE__");
             }
         } else if (x_joypads[i].attached) {
             x_joypads[i].attached = false;
-            attached_joypads[x_joypads[i].id] = false;
             input->updateJoyConnection(x_joypads[i].id, false, "");
         }
     }
 
-    for (int i = 0; i < joypad_count; i++) {
-        d_joypads[i].confirmed = false;
-    }
+    for (int slot : std::as_const(attached_slots))
+        d_joypads[slot].confirmed = false;
 
     dinput->EnumDevices(DI8DEVCLASS_GAMECTRL, enumCallback, this, DIEDFL_ATTACHEDONLY);
 
-    for (int i = 0; i < joypad_count; i++) {
-        if (!d_joypads[i].confirmed) {
-            close_joypad(i);
-        }
+    // close_joypad() removes the slot from the list
+    const auto attached = attached_slots;
+    for (int slot : attached) {
+        if (!d_joypads[slot].confirmed)
+            close_joypad(slot);
     }
 }
 
@@ -164,12 +162,8 @@ void WindowsJoystickInput::processJoypads()
         }
     }
 
-    for (int i = 0; i < JOYPADS_MAX; i++) {
-        dinput_gamepad *joy = &d_joypads[i];
-
-        if (!joy->attached) {
-            continue;
-        }
+    for (int slot : std::as_const(attached_slots)) {
+        dinput_gamepad *joy = &d_joypads[slot];
 
         DIJOYSTATE2 js;
         hr = joy->di_joy->Poll();
@@ -223,9 +217,9 @@ void WindowsJoystickInput::timerEvent(QTimerEvent *event)
 
 bool WindowsJoystickInput::have_device(const GUID &p_guid)
 {
-    for (int i = 0; i < JOYPADS_MAX; i++) {
-        if (d_joypads[i].guid == p_guid) {
-            d_joypads[i].confirmed = true;
+    for (int slot : std::as_const(attached_slots)) {
+        if (d_joypads[slot].guid == p_guid) {
+            d_joypads[slot].confirmed = true;
             return true;
         }
     }
@@ -293,13 +287,16 @@ bool WindowsJoystickInput::setup_dinput_joypad(const DIDEVICEINSTANCE *instance)
 
     HRESULT hr;
     auto input = QUniversalInput::instance();
-    int num = input->getUnusedJoyId();
 
-    if (have_device(instance->guidInstance) || num == -1)
+    if (have_device(instance->guidInstance) || attached_slots.size() == JOYPADS_MAX)
         return false;
 
-    d_joypads[num] = dinput_gamepad();
-    dinput_gamepad *joy = &d_joypads[num];
+    int slot = 0;
+    while (d_joypads[slot].attached)
+        slot++;
+
+    d_joypads[slot] = dinput_gamepad();
+    dinput_gamepad *joy = &d_joypads[slot];
 
     const DWORD devtype = (instance->dwDevType & 0xFF);
 
@@ -325,7 +322,15 @@ bool WindowsJoystickInput::setup_dinput_joypad(const DIDEVICEINSTANCE *instance)
     WORD version = 0;
     sprintf_s(uid, "%04x%04x%04x%04x%04x%04x%04x%04x", type, 0, vendor, 0, product, 0, version, 0);
 
-    id_to_change = num;
+    // Reserved until the device disconnects
+    const int id = input->allocateJoyId();
+    if (id == -1) {
+        joy->di_joy->Release();
+        joy->di_joy = nullptr;
+        return false;
+    }
+
+    id_to_change = slot;
     slider_count = 0;
 
     joy->di_joy->SetDataFormat(&c_dfDIJoystick2);
@@ -334,12 +339,11 @@ bool WindowsJoystickInput::setup_dinput_joypad(const DIDEVICEINSTANCE *instance)
     std::sort(joy->joy_axis.begin(), joy->joy_axis.end());
 
     joy->guid = instance->guidInstance;
-    input->updateJoyConnection(num, true, QString::fromWCharArray(instance->tszProductName), QString::fromLocal8Bit(uid));
+    input->updateJoyConnection(id, true, QString::fromWCharArray(instance->tszProductName), QString::fromLocal8Bit(uid));
     joy->attached = true;
-    joy->id = num;
-    attached_joypads[num] = true;
+    joy->id = id;
+    attached_slots.append(slot);
     joy->confirmed = true;
-    joypad_count++;
     return true;
 }
 
@@ -419,26 +423,24 @@ BOOL CALLBACK WindowsJoystickInput::objectsCallback(const DIDEVICEOBJECTINSTANCE
     return DIENUM_CONTINUE;
 }
 
-void WindowsJoystickInput::close_joypad(int id)
+void WindowsJoystickInput::close_joypad(int slot)
 {
-    if (id == -1) {
-        for (int i = 0; i < JOYPADS_MAX; i++) {
-            close_joypad(i);
-        }
+    if (slot == -1) {
+        while (!attached_slots.isEmpty())
+            close_joypad(attached_slots.last());
         return;
     }
 
-    if (!d_joypads[id].attached) {
+    if (!d_joypads[slot].attached) {
         return;
     }
 
-    d_joypads[id].di_joy->Unacquire();
-    d_joypads[id].di_joy->Release();
-    d_joypads[id].attached = false;
-    attached_joypads[d_joypads[id].id] = false;
-    d_joypads[id].guid.Data1 = d_joypads[id].guid.Data2 = d_joypads[id].guid.Data3 = 0;
-    QUniversalInput::instance()->updateJoyConnection(d_joypads[id].id, false, "");
-    joypad_count--;
+    d_joypads[slot].di_joy->Unacquire();
+    d_joypads[slot].di_joy->Release();
+    d_joypads[slot].attached = false;
+    attached_slots.removeOne(slot);
+    d_joypads[slot].guid.Data1 = d_joypads[slot].guid.Data2 = d_joypads[slot].guid.Data3 = 0;
+    QUniversalInput::instance()->updateJoyConnection(d_joypads[slot].id, false, "");
 }
 
 void WindowsJoystickInput::post_hat(int p_device, DWORD p_dpad)
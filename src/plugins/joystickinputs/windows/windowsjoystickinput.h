@@ -13,6 +13,7 @@
 #include <QtUniversalInput/private/qjoystickinput_p.h>
 
 #include <QtCore/QLibrary>
+#include <QtCore/QVarLengthArray>
 
 
 #include <windows.h>
@@ -38,6 +39,7 @@ protected:
 
 private:
     enum {
+        // DirectInput devices handled at once, their ids are allocated
         JOYPADS_MAX = 16,
         JOY_AXIS_COUNT = 6,
         MIN_JOY_AXIS = 10,
@@ -90,16 +92,16 @@ private:
 
     int id_to_change;
     int slider_count;
-    int joypad_count;
-    bool attached_joypads[JOYPADS_MAX];
     dinput_gamepad d_joypads[JOYPADS_MAX];
+    // The slots of d_joypads with a device attached
+    QVarLengthArray<int, JOYPADS_MAX> attached_slots;
     xinput_gamepad x_joypads[XUSER_MAX_COUNT];
 
     static BOOL CALLBACK enumCallback(const DIDEVICEINSTANCE *p_instance, void *p_context);
     static BOOL CALLBACK objectsCallback(const DIDEVICEOBJECTINSTANCE *instance, void *context);
 
     void setup_joypad_object(const DIDEVICEOBJECTINSTANCE *ob, int p_joy_id);
-    void close_joypad(int id = -1);
+    void close_joypad(int slot = -1);
     void load_xinput();
     void unload_xinput();
 
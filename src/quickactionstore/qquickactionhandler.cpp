@@ -2,6 +2,9 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qquickactionhandler_p.h"
+#include "qquickactionstore_p.h"
+
+#include <qtquickactionstore_tracepoints_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -12,59 +15,34 @@ QQuickActionHandler::QQuickActionHandler(QObject *parent)
 {
 }
 
+QQuickActionHandler::~QQuickActionHandler()
+{
+    if (m_actionStore)
+        m_actionStore->removeActionHandler(this);
+}
+
 void QQuickActionHandler::setActionStore(QQuickActionStore *actionStore)
 {
     if (m_actionStore == actionStore)
         return;
 
-    if (m_actionStore) {
-        disconnect(m_actionStore, &QQuickActionStore::actionEvent, this, nullptr);
-        disconnect(m_actionStore, &QQuickActionStore::actionKeyEvent, this, nullptr);
-    }
+    if (m_actionStore)
+        m_actionStore->removeActionHandler(this);
     m_actionStore = actionStore;
-    connect(m_actionStore, &QQuickActionStore::actionKeyEvent, this, [this](const QString &action, Qt::Key key, bool isPressed)
-            {
-                Q_UNUSED(key)
-                Q_UNUSED(isPressed)
-                if (action == m_actionTitle) {
-                    setSource(Source::Key);
-                    setValue(1.0f);
-                    emit triggered();
-                } });
-    connect(m_actionStore, &QQuickActionStore::actionMouseButtonEvent, this, [this](const QString &action, Qt::MouseButton button, bool isPressed)
-            {
-                Q_UNUSED(button)
-                Q_UNUSED(isPressed)
-                if (action == m_actionTitle) {
-                    setSource(Source::MouseButton);
-                    setValue(1.0f);
-                    emit triggered();
-                } });
-    connect(m_actionStore, &QQuickActionStore::actionJoyAxisEvent, this, [this](const QString &action, int device, JoyAxis axis, float value)
-            {
-                Q_UNUSED(device)
-                Q_UNUSED(axis)
-                if (action == m_actionTitle)
-                {
-                    setSource(Source::JoyAxis);
-                    setValue(value);
-                    emit triggered();
-                }
-            });
-    connect(m_actionStore, &QQuickActionStore::actionJoyButtonEvent, this, [this](const QString &action, int device, JoyButton button, bool isPressed)
-            {
-                Q_UNUSED(device)
-                Q_UNUSED(button)
-                Q_UNUSED(isPressed)
-                if (action == m_actionTitle) {
-                    setSource(Source::JoyButton);
-                    setValue(1.0f);
-                    emit triggered();
-                } });
+    if (m_actionStore)
+        m_actionStore->addActionHandler(this);
 
     emit actionStoreChanged();
 }
 
+void QQuickActionHandler::trigger(Source source, float value)
+{
+    setSource(source);
+    setValue(value);
+    Q_TRACE(QQuickActionHandler_triggered, m_actionTitle, int(source), value);
+    emit triggered();
+}
+
 QQuickActionStore *QQuickActionHandler::actionStore() const
 {
     return m_actionStore;
@@ -75,7 +53,12 @@ void QQuickActionHandler::setActionTitle(const QString &actionTitle)
     if (m_actionTitle == actionTitle)
         return;
 
+    // The store routes by title, so re-subscribe under the new one
+    if (m_actionStore)
+        m_actionStore->removeActionHandler(this);
     m_actionTitle = actionTitle;
+    if (m_actionStore)
+        m_actionStore->addActionHandler(this);
     emit actionTitleChanged();
 }
 
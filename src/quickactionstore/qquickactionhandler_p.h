@@ -16,10 +16,16 @@
 // We mean it.
 //
 
-#include "qquickactionstore_p.h"
+#include <QtCore/QPointer>
+#include <QtQml/QQmlEngine>
+#include <QtQml/QQmlListProperty>
+
+Q_MOC_INCLUDE("qquickactionstore_p.h")
 
 QT_BEGIN_NAMESPACE
 
+class QQuickActionStore;
+
 class QQuickActionHandler : public QObject
 {
     Q_OBJECT
@@ -40,7 +46,7 @@ public:
         Other
     };
     QQuickActionHandler(QObject *parent = nullptr);
-    ~QQuickActionHandler() override = default;
+    ~QQuickActionHandler() override;
 
     void setActionStore(QQuickActionStore *actionStore);
     QQuickActionStore* actionStore() const;
@@ -63,10 +69,13 @@ Q_SIGNALS:
 
 
 private:
-    QQuickActionStore *m_actionStore;
+    friend class QQuickActionStore;
+    void trigger(Source source, float value);
+
+    QPointer<QQuickActionStore> m_actionStore;
     QString m_actionTitle;
-    Source m_source;
-    float m_value;
+    Source m_source = Source::Other;
+    float m_value = 0.0f;
 };
 
 class QQuickActionDispatch : public QObject
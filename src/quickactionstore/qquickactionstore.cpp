@@ -2,6 +2,10 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qquickactionstore_p.h"
+#include "qquickactionhandler_p.h"
+
+#include <QtCore/QPointer>
+#include <QtCore/QVarLengthArray>
 
 QT_BEGIN_NAMESPACE
 
@@ -253,6 +257,64 @@ QActionStore::Action QQuickInputAction::action() const
 QQuickActionStore::QQuickActionStore(QObject *parent)
     : QActionStore(parent)
 {
+    connect(this, &QActionStore::actionKeyEvent, this, [this](const QString &action, Qt::Key key, bool isPressed)
+            {
+                Q_UNUSED(key)
+                Q_UNUSED(isPressed)
+                routeAction(action, QQuickActionHandler::Source::Key, 1.0f);
+            });
+    connect(this, &QActionStore::actionMouseButtonEvent, this, [this](const QString &action, Qt::MouseButton button, bool isPressed)
+            {
+                Q_UNUSED(button)
+                Q_UNUSED(isPressed)
+                routeAction(action, QQuickActionHandler::Source::MouseButton, 1.0f);
+            });
+    connect(this, &QActionStore::actionJoyAxisEvent, this, [this](const QString &action, int device, JoyAxis axis, float value)
+            {
+                Q_UNUSED(device)
+                Q_UNUSED(axis)
+                routeAction(action, QQuickActionHandler::Source::JoyAxis, value);
+            });
+    connect(this, &QActionStore::actionJoyButtonEvent, this, [this](const QString &action, int device, JoyButton button, bool isPressed)
+            {
+                Q_UNUSED(device)
+                Q_UNUSED(button)
+                Q_UNUSED(isPressed)
+                routeAction(action, QQuickActionHandler::Source::JoyButton, 1.0f);
+            });
+}
+
+void QQuickActionStore::addActionHandler(QQuickActionHandler *handler)
+{
+    auto &handlers = m_handlerRoutes[handler->actionTitle()];
+    if (!handlers.contains(handler))
+        handlers.append(handler);
+}
+
+void QQuickActionStore::removeActionHandler(QQuickActionHandler *handler)
+{
+    auto it = m_handlerRoutes.find(handler->actionTitle());
+    if (it == m_handlerRoutes.end())
+        return;
+
+    it->removeOne(handler);
+    if (it->isEmpty())
+        m_handlerRoutes.erase(it);
+}
+
+void QQuickActionStore::routeAction(const QString &action, QQuickActionHandler::Source source, float value)
+{
+    const auto it = m_handlerRoutes.constFind(action);
+    if (it == m_handlerRoutes.cend())
+        return;
+
+    // The code reacting to a handler may unsubscribe or destroy any handler
+    // of the route, so a copy is walked and each handler checked first
+    const QVarLengthArray<QPointer<QQuickActionHandler>, 8> handlers(it->cbegin(), it->cend());
+    for (const auto &handler : handlers) {
+        if (handler && handler->actionStore() == this && handler->actionTitle() == action)
+            handler->trigger(source, value);
+    }
 }
 
 QQmlListProperty<QQuickInputAction> QQuickActionStore::actions()
@@ -273,20 +335,18 @@ void QQuickActionStore::appendAction(QQmlListProperty<QQuickInputAction> *list,
     auto *self = static_cast<QQuickActionStore *>(list->object);
     self->m_actions.push_back(action);
 
-    auto actionItem = action->action();
-    self->registerAction(actionItem);
+    // While the component is being created, registration is deferred to
+    // componentComplete() so that all actions are registered in one pass.
+    if (self->m_componentComplete)
+        self->updateAction(action);
 
-    connect(action, &QQuickInputAction::titleChanged, self, [self, actionItem](){
-        self->clearActions();
-        for (auto *action : self->m_actions){
-            self->registerAction(action->action());
-        }
+    connect(action, &QQuickInputAction::titleChanged, self, [self, action]() {
+        if (self->m_componentComplete)
+            self->updateAction(action);
     });
-    connect(action, &QQuickInputAction::eventsChanged, self, [self, actionItem](){
-        self->clearActions();
-        for (auto *action : self->m_actions){
-            self->registerAction(action->action());
-        }
+    connect(action, &QQuickInputAction::eventsChanged, self, [self, action]() {
+        if (self->m_componentComplete)
+            self->updateAction(action);
     });
 
     emit self->actionsChanged();
@@ -307,10 +367,45 @@ QQuickInputAction *QQuickActionStore::atAction(QQmlListProperty<QQuickInputActio
 void QQuickActionStore::clearAction(QQmlListProperty<QQuickInputAction> *list)
 {
     auto *self = static_cast<QQuickActionStore *>(list->object);
+    for (auto *action : std::as_const(self->m_actions))
+        disconnect(action, nullptr, self, nullptr);
     self->clearActions();
     self->m_actions.clear();
+    self->m_registeredTitles.clear();
 
     emit self->actionsChanged();
 }
 
+void QQuickActionStore::classBegin()
+{
+    m_componentComplete = false;
+}
+
+void QQuickActionStore::componentComplete()
+{
+    m_componentComplete = true;
+    for (auto *action : std::as_const(m_actions))
+        updateAction(action);
+}
+
+void QQuickActionStore::updateAction(QQuickInputAction *action)
+{
+    const auto previous = m_registeredTitles.constFind(action);
+    if (previous != m_registeredTitles.cend() && *previous != action->title()) {
+        const QString oldTitle = *previous;
+        unregisterAction(oldTitle);
+        m_registeredTitles.erase(previous);
+        // Another action may share the old title; it takes over the entry.
+        for (auto *other : std::as_const(m_actions)) {
+            if (other != action && m_registeredTitles.value(other) == oldTitle) {
+                registerAction(other->action());
+                break;
+            }
+        }
+    }
+
+    registerAction(action->action());
+    m_registeredTitles.insert(action, action->title());
+}
+
 QT_END_NAMESPACE
@@ -15,10 +15,13 @@
 // We mean it.
 //
 
+#include "qquickactionhandler_p.h"
+
 #include <QtUniversalInput/QActionStore>
 #include <QtQml/QQmlEngine>
 
 #include <QtQml/QQmlListProperty>
+#include <QtQml/QQmlParserStatus>
 
 QT_BEGIN_NAMESPACE
 
@@ -70,7 +73,8 @@ public:
         MAX = 128
     };
 
-    // Taken from qactionstore.h
+    // Taken from qactionstore.h. The device property takes any device id,
+    // these only name the first ones.
     enum class Controller
     {
         All = -1,
@@ -193,7 +197,8 @@ public:
         MAX = 10,
     };
 
-    // Taken from qactionstore.h
+    // Taken from qactionstore.h. The device property takes any device id,
+    // these only name the first ones.
     enum class Controller
     {
         All = -1,
@@ -286,9 +291,10 @@ private:
     QList<QQuickInputActionEvent *> m_events;
 };
 
-class QQuickActionStore : public QActionStore
+class QQuickActionStore : public QActionStore, public QQmlParserStatus
 {
     Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
     Q_PROPERTY(QQmlListProperty<QQuickInputAction> actions READ actions)
     Q_CLASSINFO("DefaultProperty", "actions")
     QML_NAMED_ELEMENT(ActionStore)
@@ -303,11 +309,28 @@ public:
     static QQuickInputAction *atAction(QQmlListProperty<QQuickInputAction> *list, qsizetype index);
     static void clearAction(QQmlListProperty<QQuickInputAction> *list);
 
+    void classBegin() override;
+    void componentComplete() override;
+
+    void addActionHandler(QQuickActionHandler *handler);
+    void removeActionHandler(QQuickActionHandler *handler);
+
 Q_SIGNALS:
     void actionsChanged();
 
 private:
+    void updateAction(QQuickInputAction *action);
+    void routeAction(const QString &action, QQuickActionHandler::Source source, float value);
+
+    // Handlers subscribed to each action title, so that an action event
+    // only reaches the handlers that are interested in it.
+    QHash<QString, QList<QQuickActionHandler *>> m_handlerRoutes;
+
     QList<QQuickInputAction *> m_actions;
+    // Title each action is currently registered under, so that a
+    // title change only replaces that action's entry.
+    QHash<QQuickInputAction *, QString> m_registeredTitles;
+    bool m_componentComplete = true;
 };
 
 QT_END_NAMESPACE
@@ -3,12 +3,16 @@
 
 #include "qquickgamepad_p.h"
 
+#include <QtQml/qqmlinfo.h>
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QQuickWindow>
+
 QT_BEGIN_NAMESPACE
 
 QQuickGamepad::QQuickGamepad(QObject *parent)
     : QGamepad(-1, parent)
 {
-
+    connect(this, &QGamepad::updateModeChanged, this, &QQuickGamepad::updateWindow);
 }
 
 QQuickGamepad::~QQuickGamepad()
@@ -16,4 +20,63 @@ QQuickGamepad::~QQuickGamepad()
 
 }
 
+void QQuickGamepad::classBegin()
+{
+}
+
+void QQuickGamepad::componentComplete()
+{
+    // The gamepad is a plain QObject; publish on the frames of the window
+    // of the item (or window) it was declared in.
+    for (QObject *object = parent(); object; object = object->parent()) {
+        if (auto *item = qobject_cast<QQuickItem *>(object)) {
+            m_item = item;
+            connect(item, &QQuickItem::windowChanged, this, &QQuickGamepad::updateWindow);
+            break;
+        }
+        if (auto *window = qobject_cast<QQuickWindow *>(object)) {
+            m_window = window;
+            break;
+        }
+    }
+
+    m_componentComplete = true;
+    updateWindow();
+}
+
+void QQuickGamepad::updateWindow()
+{
+    if (!m_componentComplete)
+        return;
+
+    // Without a window there is no frame to publish on, and staged changes
+    // would never reach the bindings
+    if (updateMode() == FrameSynchronizedUpdates && !m_item && !m_window) {
+        qmlWarning(this) << "FrameSynchronizedUpdates needs the Gamepad to be declared "
+                            "inside an Item or a Window, falling back to ImmediateUpdates";
+        setUpdateMode(ImmediateUpdates);
+        return;
+    }
+
+    QQuickWindow *window = m_item ? m_item->window() : m_window.data();
+    if (updateMode() != FrameSynchronizedUpdates)
+        window = nullptr;
+    setWindow(window);
+}
+
+void QQuickGamepad::setWindow(QQuickWindow *window)
+{
+    disconnect(m_frameConnection);
+    disconnect(m_requestConnection);
+    if (!window)
+        return;
+
+    // afterAnimating is emitted once per frame on the GUI thread, before
+    // the scene graph is synchronized, so bindings see the state of the
+    // frame being prepared.
+    m_frameConnection = connect(window, &QQuickWindow::afterAnimating, this, &QGamepad::synchronize);
+    // Make sure a frame is coming when a change is staged on an idle scene
+    m_requestConnection = connect(this, &QGamepad::synchronizationRequested, window, &QQuickWindow::update);
+}
+
 QT_END_NAMESPACE
@@ -18,16 +18,34 @@
 
 #include <QtGamepad/QGamepad>
 #include <QtQml/QQmlEngine>
+#include <QtQml/QQmlParserStatus>
+#include <QtCore/QPointer>
 
 QT_BEGIN_NAMESPACE
 
-class QQuickGamepad : public QGamepad {
+class QQuickItem;
+class QQuickWindow;
+
+class QQuickGamepad : public QGamepad, public QQmlParserStatus {
     Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
     QML_NAMED_ELEMENT(Gamepad)
 public:
     QQuickGamepad(QObject *parent = nullptr);
     ~QQuickGamepad();
 
+    void classBegin() override;
+    void componentComplete() override;
+
+private:
+    void updateWindow();
+    void setWindow(QQuickWindow *window);
+
+    QPointer<QQuickItem> m_item;
+    QPointer<QQuickWindow> m_window;
+    QMetaObject::Connection m_frameConnection;
+    QMetaObject::Connection m_requestConnection;
+    bool m_componentComplete = false;
 };
 
 
@@ -9,6 +9,8 @@
 
 QT_BEGIN_NAMESPACE
 
+using namespace Qt::Literals::StringLiterals;
+
 class QQuickUniversalInputPrivate : public QObjectPrivate {
     Q_DECLARE_PUBLIC(QQuickUniversalInput)
 public:
@@ -44,6 +46,35 @@ void QQuickUniversalInput::setMouseDisabled(bool disabled)
     emit mouseDisabledChanged();
 }
 
+// One map per device, with the fields of QUniversalInput::DeviceStatistics
+QVariantList QQuickUniversalInput::statistics() const
+{
+    QVariantList result;
+    const auto statistics = QUniversalInput::instance()->statistics();
+    for (const auto &stats : statistics) {
+        QVariantList histogram;
+        for (quint64 count : stats.latencyHistogram)
+            histogram.append(count);
+
+        result.append(QVariantMap {
+            { u"device"_s, stats.device },
+            { u"buttonEvents"_s, stats.buttonEvents },
+            { u"axisEvents"_s, stats.axisEvents },
+            { u"hatEvents"_s, stats.hatEvents },
+            { u"buttonEventsPerSecond"_s, stats.buttonEventsPerSecond },
+            { u"axisEventsPerSecond"_s, stats.axisEventsPerSecond },
+            { u"hatEventsPerSecond"_s, stats.hatEventsPerSecond },
+            { u"latencyHistogram"_s, histogram },
+            { u"droppedEvents"_s, stats.droppedEvents },
+            { u"queueHighWaterMark"_s, stats.queueHighWaterMark },
+            { u"mappingMisses"_s, stats.mappingMisses },
+            { u"pollingRate"_s, stats.pollingRate },
+            { u"pollingJitter"_s, stats.pollingJitter },
+        });
+    }
+    return result;
+}
+
 void QQuickUniversalInput::addForce(int device, const QVector2D &force, float duration)
 {
     QUniversalInput::instance()->addForce(device, force, duration);
@@ -38,6 +38,8 @@ public:
     bool isMouseDisabled() const;
     void setMouseDisabled(bool disabled);
 
+    Q_INVOKABLE QVariantList statistics() const;
+
 Q_SIGNALS:
     void joyConnectionChanged(int index, bool isConnected);
     void joyButtonEvent(int device, JoyButton button, bool isPressed);
@@ -7,6 +7,8 @@
 
 #include <QKeyEvent>
 
+#include <qtuniversalinput_tracepoints_p.h>
+
 QT_BEGIN_NAMESPACE
 
 class QActionStorePrivate : public QObjectPrivate
@@ -50,6 +52,12 @@ void QActionStore::registerAction(const Action &action)
     d->actions.insert(action.name, action);
 }
 
+void QActionStore::unregisterAction(const QString &name)
+{
+    Q_D(QActionStore);
+    d->actions.remove(name);
+}
+
 void QActionStore::clearActions()
 {
     Q_D(QActionStore);
@@ -58,100 +66,96 @@ void QActionStore::clearActions()
 
 void QActionStorePrivate::_q_handleJoyAxisEvent(int device, JoyAxis axis, float value)
 {
-    for (int j = 0; j < actions.size(); j++) {
-        auto key = actions.keys()[j];
-        auto action = actions[key];
-        for (auto axisAction : action.axes) {
-            const auto absValue = abs(value);
+    Q_TRACE_SCOPE(QActionStore_handleJoyAxisEvent, device, int(axis), value);
+    Q_Q(QActionStore);
+    const auto absValue = qAbs(value);
+
+    // Iterate a shallow copy, slots may modify or clear the actions. The copy
+    // only detaches if they do, so the common path does not allocate.
+    const auto snapshot = actions;
+    for (const auto &action : snapshot) {
+        for (const auto &axisAction : action.axes) {
             if (axisAction.axis == axis && ((int)axisAction.device == device || axisAction.device == QActionStore::Controller::All) && absValue >= axisAction.deadzone) {
                 switch (axisAction.direction) {
                 case QActionStore::AxisDirection::Left:
                 case QActionStore::AxisDirection::Up:
                     if (value < 0) {
-                        Q_EMIT q_func()->actionEvent(action.name);
-                        Q_EMIT q_func()->actionJoyAxisEvent(action.name, device, axis, absValue);
+                        Q_EMIT q->actionEvent(action.name);
+                        Q_EMIT q->actionJoyAxisEvent(action.name, device, axis, absValue);
                     }
                     break;
                 case QActionStore::AxisDirection::Right:
                 case QActionStore::AxisDirection::Down:
                     if (value > 0) {
-                        Q_EMIT q_func()->actionEvent(action.name);
-                        Q_EMIT q_func()->actionJoyAxisEvent(action.name, device, axis, absValue);
+                        Q_EMIT q->actionEvent(action.name);
+                        Q_EMIT q->actionJoyAxisEvent(action.name, device, axis, absValue);
                     }
                     break;
                 case QActionStore::AxisDirection::All:
-                    Q_EMIT q_func()->actionEvent(action.name);
-                    Q_EMIT q_func()->actionJoyAxisEvent(action.name, device, axis, absValue);
+                    Q_EMIT q->actionEvent(action.name);
+                    Q_EMIT q->actionJoyAxisEvent(action.name, device, axis, absValue);
                     break;
                 default:
                     break;
                 };
             }
 
-            if (actions.size() == 0)
-                break;
+            if (actions.isEmpty())
+                return;
         }
-        if (actions.size() == 0)
-            break;
     }
 }
 
 void QActionStorePrivate::_q_handleJoyButtonEvent(int device, JoyButton button, bool isPressed)
 {
-    for (auto j = 0; j < actions.size(); j++) {
-        auto key = actions.keys()[j];
-        auto action = actions[key];
-
-        for (auto buttonAction : action.buttons) {
+    Q_TRACE_SCOPE(QActionStore_handleJoyButtonEvent, device, int(button), isPressed);
+    Q_Q(QActionStore);
+    const auto snapshot = actions;
+    for (const auto &action : snapshot) {
+        for (const auto &buttonAction : action.buttons) {
             if (buttonAction.button == button && buttonAction.isPressed == isPressed && ((int)buttonAction.device == device || buttonAction.device == QActionStore::Controller::All)) {
-                Q_EMIT q_func()->actionEvent(action.name);
-                Q_EMIT q_func()->actionJoyButtonEvent(action.name, device, button, isPressed);
+                Q_EMIT q->actionEvent(action.name);
+                Q_EMIT q->actionJoyButtonEvent(action.name, device, button, isPressed);
             }
-            if (actions.size() == 0)
-                break;
+            if (actions.isEmpty())
+                return;
         }
-        if (actions.size() == 0)
-            break;
     }
 }
 
 
 void QActionStore::sendKeyEvent(Qt::Key key, bool isPressed)
 {
+    Q_TRACE_SCOPE(QActionStore_sendKeyEvent, int(key), isPressed);
     Q_D(QActionStore);
-    for (auto j = 0; j < d->actions.size(); j++) {
-        auto aKey = d->actions.keys()[j];
-        auto action = d->actions[aKey];
-        for (auto keyAction : action.keys) {
+    const auto snapshot = d->actions;
+    for (const auto &action : snapshot) {
+        for (const auto &keyAction : action.keys) {
             if (keyAction.key == key && keyAction.isPressed == isPressed)
             {
                 Q_EMIT actionEvent(action.name);
                 Q_EMIT actionKeyEvent(action.name, key, isPressed);
             }
-            if (d->actions.size() == 0)
-                break;
+            if (d->actions.isEmpty())
+                return;
         }
-        if (d->actions.size() == 0)
-            break;
     }
 }
 
 void QActionStore::sendMouseButtonEvent(Qt::MouseButton button, bool isPressed)
 {
+    Q_TRACE_SCOPE(QActionStore_sendMouseButtonEvent, int(button), isPressed);
     Q_D(QActionStore);
-    for (int j = 0; j < d->actions.size(); j++) {
-        auto aKey = d->actions.keys()[j];
-        auto action = d->actions[aKey];
-        for (auto mouseButtonAction : action.mouseButtons) {
+    const auto snapshot = d->actions;
+    for (const auto &action : snapshot) {
+        for (const auto &mouseButtonAction : action.mouseButtons) {
             if (mouseButtonAction.button == button && mouseButtonAction.isPressed == isPressed) {
                 Q_EMIT actionEvent(action.name);
                 Q_EMIT actionMouseButtonEvent(action.name, button, isPressed);
             }
-            if (d->actions.size() == 0)
-                break;
+            if (d->actions.isEmpty())
+                return;
         }
-        if (d->actions.size() == 0)
-            break;
     }
 }
 
@@ -18,6 +18,8 @@ class Q_UNIVERSALINPUT_EXPORT QActionStore : public QObject
     Q_ENUMS(Controller)
     Q_ENUMS(AxisDirection)
 public:
+    // Names for the first device ids, any other id is passed as
+    // Controller(id)
     enum class Controller
     {
         All = -1,
@@ -38,7 +40,7 @@ public:
         Device14 = 14,
         Device15 = 15,
         Device16 = 16,
-        DeviceMAX = 17,
+        DeviceMAX = 17, // end of the names, not of the ids
     };
 
     enum class AxisDirection
@@ -105,6 +107,7 @@ public:
     ~QActionStore();
 
     void registerAction(const Action &action);
+    void unregisterAction(const QString &name);
     void clearActions();
 
 Q_SIGNALS:
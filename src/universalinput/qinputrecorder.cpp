@@ -0,0 +1,133 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qinputrecorder_p.h"
+#include "qinputrecording_p.h"
+
+#include <QtCore/QDebug>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QInputRecording;
+
+// Records are collected in memory and written out in blocks of about this size
+static constexpr qsizetype FlushThreshold = 4096;
+
+QInputRecorder::QInputRecorder(Sources sources)
+    : m_sources(sources)
+{
+    m_buffer.reserve(FlushThreshold + 256);
+}
+
+QInputRecorder::~QInputRecorder()
+{
+    close();
+}
+
+bool QInputRecorder::open(const QString &fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Could not open input recording" << fileName << m_file.errorString();
+        return false;
+    }
+
+    const char header[HeaderSize] = { Magic[0], Magic[1], Magic[2], Magic[3],
+                                      char(Version), char(m_sources.toInt()), 0, 0 };
+    m_file.write(header, HeaderSize);
+    m_lastTime = -1;
+    return true;
+}
+
+void QInputRecorder::close()
+{
+    if (!m_file.isOpen())
+        return;
+
+    flush();
+    m_file.close();
+}
+
+bool QInputRecorder::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+void QInputRecorder::recordConnection(qint64 timestamp, int device, bool isConnected, const QString &name, const QString &guid)
+{
+    if (!m_file.isOpen())
+        return;
+
+    beginRecord(Connection, timestamp, device);
+    m_buffer.append(char(isConnected));
+    appendString(m_buffer, isConnected ? name : QString());
+    appendString(m_buffer, isConnected ? guid : QString());
+    endRecord();
+}
+
+void QInputRecorder::recordButton(qint64 timestamp, int device, JoyButton button, bool isPressed, Source source)
+{
+    if (!m_file.isOpen() || !(m_sources & source))
+        return;
+
+    beginRecord(source == RawEvents ? RawButton : MappedButton, timestamp, device);
+    m_buffer.append(char(button));
+    m_buffer.append(char(isPressed));
+    endRecord();
+}
+
+void QInputRecorder::recordAxis(qint64 timestamp, int device, JoyAxis axis, float value, Source source)
+{
+    if (!m_file.isOpen() || !(m_sources & source))
+        return;
+
+    beginRecord(source == RawEvents ? RawAxis : MappedAxis, timestamp, device);
+    m_buffer.append(char(axis));
+    appendAxisValue(m_buffer, value);
+    endRecord();
+}
+
+void QInputRecorder::recordHat(qint64 timestamp, int device, HatMask value)
+{
+    if (!m_file.isOpen() || !(m_sources & RawEvents))
+        return;
+
+    beginRecord(RawHat, timestamp, device);
+    m_buffer.append(char(value));
+    endRecord();
+}
+
+void QInputRecorder::flush()
+{
+    if (m_buffer.isEmpty())
+        return;
+
+    m_file.write(m_buffer);
+    m_file.flush();
+    // Keeps the capacity, the next records are appended without allocating
+    m_buffer.resize(0);
+}
+
+void QInputRecorder::beginRecord(quint8 type, qint64 timestamp, int device)
+{
+    // Timestamps are nanoseconds of the monotonic clock, but only the
+    // time between records is stored, in microseconds. Events delivered
+    // out of order are recorded as happening at the same time.
+    const qint64 time = timestamp / 1000;
+    const qint64 delta = m_lastTime < 0 ? 0 : qMax<qint64>(0, time - m_lastTime);
+    m_lastTime = qMax(m_lastTime, time);
+
+    m_buffer.append(char(type));
+    appendVarint(m_buffer, quint64(delta));
+    appendVarint(m_buffer, quint64(device));
+}
+
+void QInputRecorder::endRecord()
+{
+    if (m_buffer.size() >= FlushThreshold)
+        flush();
+}
+
+QT_END_NAMESPACE
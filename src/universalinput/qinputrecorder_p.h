@@ -0,0 +1,68 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QINPUTRECORDER_P_H
+#define QINPUTRECORDER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtUniversalInput/private/qtuniversalinputglobal_p.h>
+#include <QtUniversalInput/quniversalinput.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+
+QT_BEGIN_NAMESPACE
+
+// Writes the events passing through QUniversalInput to a file in the
+// format described in qinputrecording_p.h. Called by QUniversalInput with
+// its mutex held.
+class Q_UNIVERSALINPUT_EXPORT QInputRecorder
+{
+public:
+    enum Source {
+        MappedEvents = 0x1, // events as emitted after applying the device mapping
+        RawEvents = 0x2,    // events as reported by the backend
+    };
+    Q_DECLARE_FLAGS(Sources, Source)
+
+    explicit QInputRecorder(Sources sources = MappedEvents);
+    ~QInputRecorder();
+
+    bool open(const QString &fileName);
+    void close();
+    bool isOpen() const;
+
+    Sources sources() const { return m_sources; }
+
+    void recordConnection(qint64 timestamp, int device, bool isConnected, const QString &name, const QString &guid);
+    void recordButton(qint64 timestamp, int device, JoyButton button, bool isPressed, Source source);
+    void recordAxis(qint64 timestamp, int device, JoyAxis axis, float value, Source source);
+    void recordHat(qint64 timestamp, int device, HatMask value);
+
+    void flush();
+
+private:
+    void beginRecord(quint8 type, qint64 timestamp, int device);
+    void endRecord();
+
+    QFile m_file;
+    QByteArray m_buffer;
+    Sources m_sources;
+    qint64 m_lastTime = -1; // microseconds
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(QInputRecorder::Sources)
+
+QT_END_NAMESPACE
+
+#endif // QINPUTRECORDER_P_H
@@ -0,0 +1,113 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QINPUTRECORDING_P_H
+#define QINPUTRECORDING_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtUniversalInput/private/qtuniversalinputglobal_p.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+QT_BEGIN_NAMESPACE
+
+// Binary format shared by QInputRecorder and QInputReplay.
+//
+// The file starts with an 8 byte header: the magic "QUIR", the format
+// version, the recorded sources (QInputRecorder::Sources) and two reserved
+// bytes. It is followed by records, which are only ever appended:
+//
+//   type      1 byte, RecordType
+//   delta     varint, microseconds since the previous record
+//   device    varint
+//   payload   depends on the type, see RecordType
+//
+// Varints are unsigned LEB128. Axis values are quantised to 16 bits.
+namespace QInputRecording {
+
+constexpr char Magic[4] = { 'Q', 'U', 'I', 'R' };
+constexpr quint8 Version = 1;
+constexpr int HeaderSize = 8;
+
+enum RecordType : quint8 {
+    Connection = 1, // connected (1 byte), name and guid (varint length + UTF-8)
+    RawButton,      // button (1 byte), pressed (1 byte)
+    RawAxis,        // axis (1 byte), value (int16, little endian)
+    RawHat,         // mask (1 byte)
+    MappedButton,   // as RawButton
+    MappedAxis,     // as RawAxis
+};
+
+inline void appendVarint(QByteArray &out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.append(char(value | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+inline bool readVarint(const uchar *&pos, const uchar *end, quint64 *value)
+{
+    quint64 result = 0;
+    for (int shift = 0; pos < end && shift < 64; shift += 7) {
+        const uchar byte = *pos++;
+        result |= quint64(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void appendString(QByteArray &out, const QString &string)
+{
+    const QByteArray utf8 = string.toUtf8();
+    appendVarint(out, quint64(utf8.size()));
+    out.append(utf8);
+}
+
+inline bool readString(const uchar *&pos, const uchar *end, QString *string)
+{
+    quint64 size = 0;
+    if (!readVarint(pos, end, &size) || size > quint64(end - pos))
+        return false;
+    *string = QString::fromUtf8(reinterpret_cast<const char *>(pos), qsizetype(size));
+    pos += size;
+    return true;
+}
+
+inline void appendAxisValue(QByteArray &out, float value)
+{
+    const qint16 quantised = qint16(qRound(qBound(-1.0f, value, 1.0f) * 32767.0f));
+    out.append(char(quantised & 0xff));
+    out.append(char((quantised >> 8) & 0xff));
+}
+
+inline bool readAxisValue(const uchar *&pos, const uchar *end, float *value)
+{
+    if (end - pos < 2)
+        return false;
+    const qint16 quantised = qint16(pos[0] | (pos[1] << 8));
+    pos += 2;
+    *value = quantised / 32767.0f;
+    return true;
+}
+
+} // namespace QInputRecording
+
+QT_END_NAMESPACE
+
+#endif // QINPUTRECORDING_P_H
@@ -0,0 +1,260 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qinputreplay_p.h"
+#include "qinputrecorder_p.h"
+#include "qinputrecording_p.h"
+#include "quniversalinput_p.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QTimerEvent>
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QInputRecording;
+
+// Records delivered per event loop iteration in AsFastAsPossible mode
+static constexpr int ReplayBatchSize = 1024;
+
+QInputReplay::QInputReplay()
+{
+}
+
+QInputReplay::~QInputReplay()
+{
+    // Only deleted along with QUniversalInput, the devices go with it
+    stop();
+}
+
+bool QInputReplay::open(const QString &fileName)
+{
+    stop();
+    releaseDevices();
+    m_file.close();
+    m_pos = m_end = nullptr;
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open input recording" << fileName << m_file.errorString();
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    const uchar *data = size >= HeaderSize ? m_file.map(0, size) : nullptr;
+    if (!data || memcmp(data, Magic, sizeof(Magic)) != 0 || data[4] != Version) {
+        qWarning() << "Not a supported input recording:" << fileName;
+        m_file.close();
+        return false;
+    }
+
+    m_replayRaw = QInputRecorder::Sources::fromInt(data[5]).testFlag(QInputRecorder::RawEvents);
+    m_pos = data + HeaderSize;
+    m_end = data + size;
+    m_nextTime = 0;
+    return true;
+}
+
+void QInputReplay::start(Mode mode)
+{
+    m_mode = mode;
+    if (!readRecordHeader()) {
+        Q_EMIT finished();
+        return;
+    }
+
+    m_clock.start();
+    m_startTimestamp = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+    scheduleNext();
+}
+
+void QInputReplay::stop()
+{
+    m_timer.stop();
+}
+
+bool QInputReplay::isFinished() const
+{
+    return m_pos == m_end;
+}
+
+void QInputReplay::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != m_timer.timerId()) {
+        QJoystickInput::timerEvent(event);
+        return;
+    }
+
+    m_timer.stop();
+
+    const qint64 now = m_clock.nsecsElapsed() / 1000;
+    for (int played = 0; ; ++played) {
+        if (m_mode == RealTime ? m_nextTime > now : played == ReplayBatchSize) {
+            scheduleNext();
+            return;
+        }
+        if (!playRecord() || !readRecordHeader())
+            break;
+    }
+
+    m_pos = m_end;
+    Q_EMIT finished();
+}
+
+bool QInputReplay::readRecordHeader()
+{
+    if (m_pos >= m_end)
+        return false;
+
+    m_nextType = *m_pos++;
+    quint64 delta = 0;
+    quint64 device = 0;
+    if (!readVarint(m_pos, m_end, &delta) || !readVarint(m_pos, m_end, &device)) {
+        qWarning() << "Truncated input recording" << m_file.fileName();
+        return false;
+    }
+
+    // Checked before the narrowing, a huge id would wrap into a valid one
+    if (device >= quint64(QUniversalInput::JoypadsMax)) {
+        qWarning() << "Invalid device" << device << "in input recording" << m_file.fileName();
+        return false;
+    }
+
+    m_nextTime += qint64(delta);
+    m_nextDevice = int(device);
+    return true;
+}
+
+bool QInputReplay::playRecord()
+{
+    auto input = QUniversalInput::instance();
+    const int device = deviceFor(m_nextDevice);
+    // Events keep the time between them they were recorded with, whatever the mode
+    const qint64 timestamp = m_startTimestamp + m_nextTime * 1000;
+
+    switch (m_nextType) {
+    case Connection: {
+        QString name;
+        QString guid;
+        if (m_pos == m_end)
+            break;
+        const bool isConnected = *m_pos++;
+        if (!readString(m_pos, m_end, &name) || !readString(m_pos, m_end, &guid))
+            break;
+        if (device != -1)
+            input->updateJoyConnection(device, isConnected, name, guid);
+        // Disconnecting released the id
+        if (!isConnected)
+            m_devices.remove(m_nextDevice);
+        return true;
+    }
+    case RawButton:
+    case MappedButton: {
+        if (m_end - m_pos < 2)
+            break;
+        const JoyButton button = JoyButton(m_pos[0]);
+        const bool isPressed = m_pos[1];
+        m_pos += 2;
+        // Out of range values would index past the state of QUniversalInput
+        if (int(button) >= int(JoyButton::MAX)) {
+            qWarning() << "Invalid button" << int(button) << "in input recording" << m_file.fileName();
+            return true;
+        }
+        if (device == -1)
+            return true;
+        if (m_nextType == RawButton && m_replayRaw) {
+            input->joyButton(device, button, isPressed, timestamp);
+        } else if (m_nextType == MappedButton && !m_replayRaw) {
+            auto d = static_cast<QUniversalInputPrivate *>(QObjectPrivate::get(input));
+            QMutexLocker locker(&d->mutex);
+            d->setEventTimestamp(timestamp);
+            input->sendButtonEvent(device, button, isPressed);
+        }
+        return true;
+    }
+    case RawAxis:
+    case MappedAxis: {
+        if (m_pos == m_end)
+            break;
+        const JoyAxis axis = JoyAxis(*m_pos++);
+        float value = 0.0f;
+        if (!readAxisValue(m_pos, m_end, &value))
+            break;
+        if (int(axis) >= int(JoyAxis::MAX)) {
+            qWarning() << "Invalid axis" << int(axis) << "in input recording" << m_file.fileName();
+            return true;
+        }
+        if (device == -1)
+            return true;
+        if (m_nextType == RawAxis && m_replayRaw) {
+            input->joyAxis(device, axis, value, timestamp);
+        } else if (m_nextType == MappedAxis && !m_replayRaw) {
+            auto d = static_cast<QUniversalInputPrivate *>(QObjectPrivate::get(input));
+            QMutexLocker locker(&d->mutex);
+            d->setEventTimestamp(timestamp);
+            input->sendAxisEvent(device, axis, value);
+        }
+        return true;
+    }
+    case RawHat: {
+        if (m_pos == m_end)
+            break;
+        const HatMask value = HatMask(*m_pos++);
+        if (int(value) > (int(HatMask::Up) | int(HatMask::Right) | int(HatMask::Down) | int(HatMask::Left))) {
+            qWarning() << "Invalid hat value" << int(value) << "in input recording" << m_file.fileName();
+            return true;
+        }
+        if (m_replayRaw && device != -1)
+            input->joyHat(device, value, timestamp);
+        return true;
+    }
+    default:
+        // The size of unknown records is not known, so nothing after them can be read
+        qWarning() << "Unknown record" << m_nextType << "in input recording" << m_file.fileName();
+        return false;
+    }
+
+    qWarning() << "Truncated input recording" << m_file.fileName();
+    return false;
+}
+
+// Allocates an id for a recorded one when it first shows up. Events of
+// devices that never connected are replayed as well, like those of the
+// virtual pads of QML. -1 if the ids ran out.
+int QInputReplay::deviceFor(int recorded)
+{
+    auto it = m_devices.constFind(recorded);
+    if (it == m_devices.cend())
+        it = m_devices.insert(recorded, QUniversalInput::instance()->allocateJoyId());
+    return *it;
+}
+
+// Disconnects the devices the replay left connected, and gives back the ids
+// of those that never connected
+void QInputReplay::releaseDevices()
+{
+    auto input = QUniversalInput::instance();
+    for (int device : std::as_const(m_devices)) {
+        if (device == -1)
+            continue;
+        if (input->isJoyConnected(device))
+            input->updateJoyConnection(device, false, QString());
+        else
+            input->releaseJoyId(device);
+    }
+    m_devices.clear();
+}
+
+void QInputReplay::scheduleNext()
+{
+    int interval = 0;
+    if (m_mode == RealTime) {
+        const qint64 wait = m_nextTime - m_clock.nsecsElapsed() / 1000;
+        interval = int(qMax<qint64>(0, (wait + 999) / 1000));
+    }
+    m_timer.start(interval, Qt::PreciseTimer, this);
+}
+
+QT_END_NAMESPACE
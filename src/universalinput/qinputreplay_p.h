@@ -0,0 +1,88 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QINPUTREPLAY_P_H
+#define QINPUTREPLAY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtUniversalInput/private/qtuniversalinputglobal_p.h>
+#include <QtUniversalInput/private/qjoystickinput_p.h>
+
+#include <QtCore/QBasicTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+
+QT_BEGIN_NAMESPACE
+
+// Joystick backend playing back a file written by QInputRecorder. The file
+// is memory mapped, so long sessions are paged in as they are played.
+class Q_UNIVERSALINPUT_EXPORT QInputReplay : public QJoystickInput
+{
+    Q_OBJECT
+public:
+    enum Mode {
+        RealTime,        // keep the recorded time between events
+        AsFastAsPossible // deliver events back to back, yielding to the event loop in between batches
+    };
+
+    QInputReplay();
+    ~QInputReplay();
+
+    // The replay drives itself, the backend interface is not used
+    using QJoystickInput::start;
+    using QJoystickInput::stop;
+
+    bool open(const QString &fileName);
+    void start(Mode mode = RealTime);
+    void stop();
+
+    bool isFinished() const;
+
+Q_SIGNALS:
+    void finished();
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    bool readRecordHeader();
+    bool playRecord();
+    void scheduleNext();
+    int deviceFor(int recorded);
+    void releaseDevices();
+
+    QFile m_file;
+    const uchar *m_pos = nullptr;
+    const uchar *m_end = nullptr;
+    // Raw events are replayed through the device mapping. Mapped events are
+    // only replayed when the file holds nothing else.
+    bool m_replayRaw = false;
+    Mode m_mode = RealTime;
+
+    quint8 m_nextType = 0;
+    int m_nextDevice = 0;
+    qint64 m_nextTime = 0; // microseconds since the first record
+
+    // The recorded ids would clash with the devices of other backends, the
+    // replayed devices take ids of this process instead
+    QHash<int, int> m_devices;
+
+    QElapsedTimer m_clock;
+    qint64 m_startTimestamp = 0; // event timestamp of the first record, in nanoseconds
+    QBasicTimer m_timer;
+};
+
+QT_END_NAMESPACE
+
+#endif // QINPUTREPLAY_P_H
@@ -0,0 +1,423 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qinputservice_p.h"
+#include "quniversalinput_p.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QDebug>
+
+#include <cstring>
+
+#if defined(Q_OS_UNIX)
+#include <errno.h>
+#include <signal.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+using namespace QInputService;
+
+// Clients that could not attach try again this often, in nanoseconds
+static constexpr qint64 AttachRetryInterval = 1000 * 1000 * 1000;
+
+QString QInputService::keyFromEnvironment()
+{
+    const QString key = qEnvironmentVariable("QT_UNIVERSALINPUT_SERVICE_KEY");
+    return key.isEmpty() ? QStringLiteral("qtuniversalinput") : key;
+}
+
+static quint32 eventHeader(EventType type, int device, int index)
+{
+    return quint32(type) | quint32(index & 0xff) << 8 | quint32(device) << 16;
+}
+
+// Whether the service that wrote the segment still runs. A recycled pid
+// reads as running, which refuses the takeover rather than breaking a live
+// service.
+static bool isPublisherAlive(qint64 pid)
+{
+    if (pid <= 0 || pid == QCoreApplication::applicationPid())
+        return false;
+#if defined(Q_OS_UNIX)
+    return kill(pid_t(pid), 0) == 0 || errno == EPERM;
+#else
+    // Named segments go away with the last process having them open, so one
+    // that exists belongs to a running service
+    return true;
+#endif
+}
+
+QInputServicePublisher::QInputServicePublisher()
+{
+}
+
+QInputServicePublisher::~QInputServicePublisher()
+{
+    if (m_segment)
+        m_segment->publisherPid.store(0, std::memory_order_release);
+    m_memory.detach();
+}
+
+bool QInputServicePublisher::open(const QString &key)
+{
+    m_memory.setNativeKey(QSharedMemory::platformSafeKey(key));
+    const bool created = m_memory.create(sizeof(Segment));
+    if (!created && (m_memory.error() != QSharedMemory::AlreadyExists || !m_memory.attach())) {
+        qWarning() << "Could not create the input service segment" << key << m_memory.errorString();
+        return false;
+    }
+    if (m_memory.size() < qsizetype(sizeof(Segment))) {
+        qWarning() << "The input service segment" << key << "has an unexpected size";
+        m_memory.detach();
+        return false;
+    }
+
+    // Two services starting together must not both take the segment
+    if (!m_memory.lock()) {
+        qWarning() << "Could not lock the input service segment" << key << m_memory.errorString();
+        m_memory.detach();
+        return false;
+    }
+
+    auto segment = static_cast<Segment *>(m_memory.data());
+    const bool known = !created && segment->magic == Magic && segment->version == Version;
+    if (known) {
+        const qint64 pid = segment->publisherPid.load(std::memory_order_acquire);
+        if (isPublisherAlive(pid)) {
+            qWarning() << "The input service segment" << key << "is published by the running process" << pid;
+            m_memory.unlock();
+            m_memory.detach();
+            return false;
+        }
+    }
+    if (!created)
+        qWarning() << "Taking over the stale input service segment" << key;
+
+    m_segment = segment;
+    const quint32 generation = known ? m_segment->generation.load(std::memory_order_relaxed) + 1 : 1;
+
+    for (Device &device : m_segment->devices) {
+        device.version.store(0, std::memory_order_relaxed);
+        device.connected.store(0, std::memory_order_relaxed);
+        memset(device.name, 0, sizeof(device.name));
+        memset(device.guid, 0, sizeof(device.guid));
+        for (auto &word : device.buttons)
+            word.store(0, std::memory_order_relaxed);
+        for (auto &axis : device.axes)
+            axis.store(0.0f, std::memory_order_relaxed);
+    }
+    for (Event &event : m_segment->events)
+        event.sequence.store(0, std::memory_order_relaxed);
+    m_segment->writeIndex.store(0, std::memory_order_relaxed);
+    m_segment->magic = Magic;
+    m_segment->version = Version;
+    m_segment->publisherPid.store(QCoreApplication::applicationPid(), std::memory_order_relaxed);
+    // Clients seeing the new generation read everything again
+    m_segment->generation.store(generation, std::memory_order_release);
+    m_memory.unlock();
+    return true;
+}
+
+void QInputServicePublisher::publishConnection(qint64 timestamp, int device, bool isConnected, const QString &name,
+                                               const QString &guid)
+{
+    if (!m_segment || device < 0 || device >= MaxDevices)
+        return;
+
+    Device &slot = m_segment->devices[device];
+    const quint32 version = slot.version.load(std::memory_order_relaxed);
+    slot.version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.connected.store(isConnected, std::memory_order_relaxed);
+    qstrncpy(slot.name, isConnected ? name.toUtf8().constData() : "", sizeof(slot.name));
+    qstrncpy(slot.guid, isConnected ? guid.toUtf8().constData() : "", sizeof(slot.guid));
+    for (auto &word : slot.buttons)
+        word.store(0, std::memory_order_relaxed);
+    for (auto &axis : slot.axes)
+        axis.store(0.0f, std::memory_order_relaxed);
+
+    slot.version.store(version + 2, std::memory_order_release);
+    append(timestamp, Connection, device, 0, isConnected ? 1.0f : 0.0f);
+}
+
+void QInputServicePublisher::publishButton(qint64 timestamp, int device, JoyButton button, bool isPressed)
+{
+    if (!m_segment || device < 0 || device >= MaxDevices || int(button) < 0 || int(button) >= int(JoyButton::MAX))
+        return;
+
+    std::atomic<quint64> &word = m_segment->devices[device].buttons[int(button) / 64];
+    const quint64 bit = quint64(1) << (int(button) % 64);
+    const quint64 buttons = word.load(std::memory_order_relaxed);
+    word.store(isPressed ? buttons | bit : buttons & ~bit, std::memory_order_relaxed);
+    append(timestamp, Button, device, int(button), isPressed ? 1.0f : 0.0f);
+}
+
+void QInputServicePublisher::publishAxis(qint64 timestamp, int device, JoyAxis axis, float value)
+{
+    if (!m_segment || device < 0 || device >= MaxDevices || int(axis) < 0 || int(axis) >= Axes)
+        return;
+
+    m_segment->devices[device].axes[int(axis)].store(value, std::memory_order_relaxed);
+    append(timestamp, Axis, device, int(axis), value);
+}
+
+void QInputServicePublisher::append(qint64 timestamp, EventType type, int device, int index, float value)
+{
+    const quint64 index64 = m_segment->writeIndex.load(std::memory_order_relaxed);
+    Event &event = m_segment->events[index64 % RingSize];
+
+    event.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.timestamp.store(timestamp, std::memory_order_relaxed);
+    event.header.store(eventHeader(type, device, index), std::memory_order_relaxed);
+    event.value.store(value, std::memory_order_relaxed);
+    event.sequence.store(index64 + 1, std::memory_order_release);
+
+    m_segment->writeIndex.store(index64 + 1, std::memory_order_release);
+}
+
+QInputServiceClient::QInputServiceClient(const QString &key)
+{
+    m_memory.setNativeKey(QSharedMemory::platformSafeKey(key));
+}
+
+QInputServiceClient::~QInputServiceClient()
+{
+    m_memory.detach();
+}
+
+QJoystickInput::Capabilities QInputServiceClient::capabilities() const
+{
+    return PollDriven | Hotplug | DeviceTimestamps;
+}
+
+bool QInputServiceClient::start(EventSink &sink)
+{
+    // The service may start later, it is looked for again while polling
+    if (attach())
+        resync(sink);
+    return true;
+}
+
+void QInputServiceClient::stop(EventSink &sink)
+{
+    detach(sink);
+}
+
+// The ring is checked on a short interval, the service does not wake its
+// clients
+int QInputServiceClient::pollInterval() const
+{
+    return 1;
+}
+
+void QInputServiceClient::poll(EventSink &sink)
+{
+    if (!m_segment) {
+        const qint64 now = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+        if (now < m_nextAttach)
+            return;
+        m_nextAttach = now + AttachRetryInterval;
+        if (attach())
+            resync(sink);
+        return;
+    }
+
+    // Another service took over, its devices are new ones
+    if (m_segment->generation.load(std::memory_order_acquire) != m_generation) {
+        for (int device = 0; device < MaxDevices; device++)
+            setConnected(device, false, sink);
+        resync(sink);
+        return;
+    }
+
+    const quint64 end = m_segment->writeIndex.load(std::memory_order_acquire);
+    if (end < m_readIndex || end - m_readIndex > RingSize) {
+        for (int device = 0; device < MaxDevices; device++) {
+            if (m_devices[device].connected)
+                sink.eventsDropped(device);
+        }
+        resync(sink);
+        return;
+    }
+
+    for (; m_readIndex < end; m_readIndex++) {
+        const Event &event = m_segment->events[m_readIndex % RingSize];
+        if (event.sequence.load(std::memory_order_acquire) != m_readIndex + 1) {
+            resync(sink);
+            return;
+        }
+        const qint64 timestamp = event.timestamp.load(std::memory_order_relaxed);
+        const quint32 header = event.header.load(std::memory_order_relaxed);
+        const float value = event.value.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // Overwritten while we read it, we fell a ring behind
+        if (event.sequence.load(std::memory_order_relaxed) != m_readIndex + 1) {
+            resync(sink);
+            return;
+        }
+
+        const int device = int(header >> 16);
+        const int index = int((header >> 8) & 0xff);
+        if (device >= MaxDevices)
+            continue;
+        switch (EventType(header & 0xff)) {
+        case Connection:
+            setConnected(device, value != 0.0f, sink);
+            break;
+        case Button:
+            setButton(device, index, value != 0.0f, timestamp);
+            break;
+        case Axis:
+            setAxis(device, index, value, timestamp);
+            break;
+        }
+    }
+}
+
+bool QInputServiceClient::attach()
+{
+    if (!m_memory.attach(QSharedMemory::ReadOnly))
+        return false;
+
+    const auto segment = static_cast<const Segment *>(m_memory.constData());
+    if (m_memory.size() < qsizetype(sizeof(Segment)) || segment->magic != Magic || segment->version != Version) {
+        qWarning() << "Incompatible input service segment" << m_memory.nativeKey();
+        m_memory.detach();
+        return false;
+    }
+    m_segment = segment;
+    return true;
+}
+
+void QInputServiceClient::detach(EventSink &sink)
+{
+    for (int device = 0; device < MaxDevices; device++)
+        setConnected(device, false, sink);
+    m_memory.detach();
+    m_segment = nullptr;
+}
+
+// Brings the devices up to the snapshots in the segment and continues with
+// the events after them. Events published while the snapshots are read are
+// delivered again, which changes nothing once they have been applied.
+void QInputServiceClient::resync(EventSink &sink)
+{
+    m_generation = m_segment->generation.load(std::memory_order_acquire);
+    m_readIndex = m_segment->writeIndex.load(std::memory_order_acquire);
+
+    for (int device = 0; device < MaxDevices; device++) {
+        const Device &slot = m_segment->devices[device];
+        bool connected = false;
+        if (!readDevice(device, &connected, nullptr, nullptr))
+            continue;
+        // A device that was replaced while we were not looking
+        if (m_devices[device].connected && connected
+            && slot.version.load(std::memory_order_relaxed) != m_devices[device].version) {
+            setConnected(device, false, sink);
+        }
+        setConnected(device, connected, sink);
+        if (!m_devices[device].connected)
+            continue;
+
+        for (int button = 0; button < int(JoyButton::MAX); button++) {
+            const quint64 word = slot.buttons[button / 64].load(std::memory_order_relaxed);
+            setButton(device, button, word & (quint64(1) << (button % 64)), 0);
+        }
+        for (int axis = 0; axis < Axes; axis++)
+            setAxis(device, axis, slot.axes[axis].load(std::memory_order_relaxed), 0);
+    }
+}
+
+// The name and guid change together with the connection, a consistent copy
+// of them is retried a few times before giving up until the next event
+bool QInputServiceClient::readDevice(int device, bool *connected, QString *name, QString *guid) const
+{
+    const Device &slot = m_segment->devices[device];
+    for (int attempt = 0; attempt < 16; attempt++) {
+        const quint32 version = slot.version.load(std::memory_order_acquire);
+        if (version & 1)
+            continue;
+        char nameCopy[NameSize];
+        char guidCopy[GuidSize];
+        memcpy(nameCopy, slot.name, sizeof(nameCopy));
+        memcpy(guidCopy, slot.guid, sizeof(guidCopy));
+        const bool isConnected = slot.connected.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) != version)
+            continue;
+
+        nameCopy[NameSize - 1] = 0;
+        guidCopy[GuidSize - 1] = 0;
+        *connected = isConnected;
+        if (name)
+            *name = QString::fromUtf8(nameCopy);
+        if (guid)
+            *guid = QString::fromUtf8(guidCopy);
+        return true;
+    }
+    return false;
+}
+
+void QInputServiceClient::setConnected(int device, bool isConnected, EventSink &sink)
+{
+    DeviceState &state = m_devices[device];
+    if (!isConnected) {
+        if (state.connected)
+            sink.connectionChanged(device, false, QString(), QString(), QString());
+        state = DeviceState();
+        return;
+    }
+
+    if (state.connected)
+        return;
+    bool connected = false;
+    QString name;
+    QString guid;
+    if (!m_segment || !readDevice(device, &connected, &name, &guid) || !connected)
+        return;
+    // The service has mapped the device already, the guid is passed on so
+    // that the device can be told apart, but it has no mapping here
+    const QString physicalId = QStringLiteral("service:%1:%2").arg(m_memory.nativeKey()).arg(device);
+    if (!sink.connectionChanged(device, true, name, guid, physicalId))
+        return;
+    state.connected = true;
+    state.version = m_segment->devices[device].version.load(std::memory_order_relaxed);
+}
+
+void QInputServiceClient::setButton(int device, int button, bool isPressed, qint64 timestamp)
+{
+    DeviceState &state = m_devices[device];
+    if (!state.connected || button >= int(JoyButton::MAX))
+        return;
+    quint64 &word = state.buttons[button / 64];
+    const quint64 bit = quint64(1) << (button % 64);
+    if (bool(word & bit) == isPressed)
+        return;
+    word = isPressed ? word | bit : word & ~bit;
+
+    auto input = QUniversalInput::instance();
+    auto d = static_cast<QUniversalInputPrivate *>(QObjectPrivate::get(input));
+    QMutexLocker locker(&d->mutex);
+    d->setEventTimestamp(timestamp);
+    input->sendButtonEvent(device, JoyButton(button), isPressed);
+}
+
+void QInputServiceClient::setAxis(int device, int axis, float value, qint64 timestamp)
+{
+    DeviceState &state = m_devices[device];
+    if (!state.connected || axis >= Axes || state.axes[axis] == value)
+        return;
+    state.axes[axis] = value;
+
+    auto input = QUniversalInput::instance();
+    auto d = static_cast<QUniversalInputPrivate *>(QObjectPrivate::get(input));
+    QMutexLocker locker(&d->mutex);
+    d->setEventTimestamp(timestamp);
+    input->sendAxisEvent(device, JoyAxis(axis), value);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,158 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QINPUTSERVICE_P_H
+#define QINPUTSERVICE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtUniversalInput/private/qtuniversalinputglobal_p.h>
+#include <QtUniversalInput/private/qjoystickinput_p.h>
+
+#include <QtCore/QSharedMemory>
+
+#include <atomic>
+
+QT_REQUIRE_CONFIG(sharedmemory);
+
+QT_BEGIN_NAMESPACE
+
+// Lets one process own the devices and the mapping database, and any number
+// of other processes see the mapped events, with the same device ids.
+//
+// The service publishes into a shared memory segment named by
+// QT_UNIVERSALINPUT_SERVICE_KEY: a snapshot of every device and a ring of
+// the mapped events. Clients attach read-only and never block the service;
+// a client that falls more than a ring behind resynchronizes from the
+// snapshots. The segment is written by the input thread of the service
+// alone, readers check every slot they read with a sequence number.
+namespace QInputService {
+
+constexpr quint32 Magic = 0x53495551; // "QUIS"
+constexpr quint32 Version = 4;
+
+// Every device id QUniversalInput hands out is published, a slot is a few
+// hundred bytes
+constexpr int MaxDevices = QUniversalInput::JoypadsMax;
+constexpr int RingSize = 4096;
+constexpr int NameSize = 128;
+constexpr int GuidSize = 64;
+constexpr int ButtonWords = (int(JoyButton::MAX) + 63) / 64;
+constexpr int Axes = int(JoyAxis::MAX);
+
+enum EventType : quint8 {
+    Connection, // value is 1 for connected, 0 for disconnected
+    Button,     // value is 1 for pressed
+    Axis,
+};
+
+struct Event {
+    // Index of the event in the stream plus one, 0 while it is written
+    std::atomic<quint64> sequence;
+    std::atomic<qint64> timestamp;
+    std::atomic<quint32> header; // type | index << 8 | device << 16
+    std::atomic<float> value;
+};
+
+struct Device {
+    // Odd while the connection, name or guid change
+    std::atomic<quint32> version;
+    std::atomic<quint32> connected;
+    char name[NameSize]; // UTF-8, null terminated
+    char guid[GuidSize];
+    // Mapped state, updated before the event announcing the change
+    std::atomic<quint64> buttons[ButtonWords];
+    std::atomic<float> axes[Axes];
+};
+
+struct Segment {
+    quint32 magic;
+    quint32 version;
+    // Bumped when a service takes the segment over, clients start afresh
+    std::atomic<quint32> generation;
+    // Process id of the service, 0 once it shut down. A segment of a service
+    // that is still running is not taken over.
+    std::atomic<qint64> publisherPid;
+    std::atomic<quint64> writeIndex;
+    Device devices[MaxDevices];
+    Event events[RingSize];
+};
+
+static_assert(MaxDevices <= 0xffff, "Event::header has 16 bits for the device");
+static_assert(std::atomic<quint64>::is_always_lock_free && std::atomic<float>::is_always_lock_free,
+              "The service segment is shared between processes");
+
+QString keyFromEnvironment();
+
+} // namespace QInputService
+
+// The service side, fed from QUniversalInput with the device mutex held
+class QInputServicePublisher
+{
+public:
+    QInputServicePublisher();
+    ~QInputServicePublisher();
+
+    bool open(const QString &key);
+
+    void publishConnection(qint64 timestamp, int device, bool isConnected, const QString &name, const QString &guid);
+    void publishButton(qint64 timestamp, int device, JoyButton button, bool isPressed);
+    void publishAxis(qint64 timestamp, int device, JoyAxis axis, float value);
+
+private:
+    void append(qint64 timestamp, QInputService::EventType type, int device, int index, float value);
+
+    QSharedMemory m_memory;
+    QInputService::Segment *m_segment = nullptr;
+};
+
+// The client side, a joystick backend presenting the devices of a service
+class QInputServiceClient : public QJoystickInput
+{
+    Q_OBJECT
+public:
+    explicit QInputServiceClient(const QString &key);
+    ~QInputServiceClient();
+
+    Capabilities capabilities() const override;
+    bool start(EventSink &sink) override;
+    void stop(EventSink &sink) override;
+    int pollInterval() const override;
+    void poll(EventSink &sink) override;
+
+private:
+    struct DeviceState {
+        bool connected = false;
+        quint32 version = 0; // of the slot when the device connected
+        quint64 buttons[QInputService::ButtonWords] = {};
+        float axes[QInputService::Axes] = {};
+    };
+
+    bool attach();
+    void detach(EventSink &sink);
+    void resync(EventSink &sink);
+    bool readDevice(int device, bool *connected, QString *name, QString *guid) const;
+    void setConnected(int device, bool isConnected, EventSink &sink);
+    void setButton(int device, int button, bool isPressed, qint64 timestamp);
+    void setAxis(int device, int axis, float value, qint64 timestamp);
+
+    QSharedMemory m_memory;
+    const QInputService::Segment *m_segment = nullptr;
+    quint32 m_generation = 0;
+    quint64 m_readIndex = 0;
+    qint64 m_nextAttach = 0;
+    DeviceState m_devices[QInputService::MaxDevices];
+};
+
+QT_END_NAMESPACE
+
+#endif // QINPUTSERVICE_P_H
@@ -0,0 +1,83 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qjoystickinput_p.h"
+
+QT_BEGIN_NAMESPACE
+
+QJoystickInput::EventSink::~EventSink() = default;
+
+void QJoystickInput::EventSink::motion(int device, const QUniversalInput::MotionSample &sample)
+{
+    Q_UNUSED(device);
+    Q_UNUSED(sample);
+}
+
+void QJoystickInput::EventSink::touch(int device, const QUniversalInput::TouchContact *contacts, int count,
+                                      qint64 timestamp)
+{
+    Q_UNUSED(device);
+    Q_UNUSED(contacts);
+    Q_UNUSED(count);
+    Q_UNUSED(timestamp);
+}
+
+void QJoystickInput::EventSink::eventsDropped(int device)
+{
+    Q_UNUSED(device);
+}
+
+void QJoystickInput::EventSink::queueDepth(int device, int pending)
+{
+    Q_UNUSED(device);
+    Q_UNUSED(pending);
+}
+
+QJoystickInput::QJoystickInput(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QJoystickInput::~QJoystickInput() = default;
+
+QJoystickInput::Capabilities QJoystickInput::capabilities() const
+{
+    return NoCapabilities;
+}
+
+bool QJoystickInput::start(EventSink &sink)
+{
+    Q_UNUSED(sink);
+    return true;
+}
+
+void QJoystickInput::stop(EventSink &sink)
+{
+    Q_UNUSED(sink);
+}
+
+QList<qintptr> QJoystickInput::pollDescriptors() const
+{
+    return {};
+}
+
+int QJoystickInput::pollInterval() const
+{
+    return -1;
+}
+
+void QJoystickInput::poll(EventSink &sink)
+{
+    Q_UNUSED(sink);
+}
+
+bool QJoystickInput::setRumble(int device, float weakMagnitude, float strongMagnitude, int durationMs)
+{
+    Q_UNUSED(device);
+    Q_UNUSED(weakMagnitude);
+    Q_UNUSED(strongMagnitude);
+    Q_UNUSED(durationMs);
+    return false;
+}
+
+QT_END_NAMESPACE
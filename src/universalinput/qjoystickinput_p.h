@@ -16,15 +16,99 @@
 //
 
 #include <QtCore/qobject.h>
+#include <QtCore/QList>
 #include <QtUniversalInput/private/qtuniversalinputglobal_p.h>
+#include <QtUniversalInput/quniversalinput.h>
 
 QT_BEGIN_NAMESPACE
 
+// Base class of the joystick backends.
+//
+// Backends reporting PollDriven are run by QJoystickInputDriver: it starts
+// them, waits on their descriptors and timer, and calls poll() to collect
+// whatever is pending into an EventSink. The core thereby decides which
+// thread a backend runs on and how its events are batched, and a backend
+// can be exercised with nothing but a sink of its own.
+//
+// Other backends drive themselves, with timers or platform callbacks, and
+// report to QUniversalInput directly.
 class Q_UNIVERSALINPUT_EXPORT QJoystickInput : public QObject
 {
     Q_OBJECT
+public:
+    enum Capability {
+        NoCapabilities = 0x0,
+        PollDriven = 0x1,       // run through start(), poll() and stop()
+        Hotplug = 0x2,          // reports devices connected after start()
+        Rumble = 0x4,           // implements setRumble()
+        DeviceTimestamps = 0x8, // events carry the time the device reported them
+        MotionSensors = 0x10,   // reports accelerometer and gyroscope samples
+        Touchpad = 0x20,        // reports the contacts on touchpads of devices
+    };
+    Q_DECLARE_FLAGS(Capabilities, Capability)
+
+    // Receives the output of a backend. All calls come from the thread the
+    // backend lives on.
+    class Q_UNIVERSALINPUT_EXPORT EventSink
+    {
+    public:
+        virtual ~EventSink();
+
+        // Device slots are shared by all backends. A slot is reserved by
+        // allocateDevice() until the device connected to it disconnects,
+        // or it is given back with releaseDevice().
+        virtual int allocateDevice() = 0;
+        virtual void releaseDevice(int device) = 0;
+        // Returns false if another backend already provides the device with
+        // the same physicalId, in which case the slot has been released
+        virtual bool connectionChanged(int device, bool isConnected, const QString &name, const QString &guid,
+                                       const QString &physicalId) = 0;
+
+        // Timestamps are monotonic nanoseconds, 0 if not known
+        virtual void button(int device, JoyButton button, bool isPressed, qint64 timestamp) = 0;
+        virtual void axis(int device, JoyAxis axis, float value, qint64 timestamp) = 0;
+        virtual void hat(int device, HatMask value, qint64 timestamp) = 0;
+        // One reading of the motion sensors of a device, in calibrated units
+        virtual void motion(int device, const QUniversalInput::MotionSample &sample);
+        // All contacts on the touchpad of a device after a change, the
+        // velocity is filled in by QUniversalInput
+        virtual void touch(int device, const QUniversalInput::TouchContact *contacts, int count, qint64 timestamp);
+
+        // Optional diagnostics, see QUniversalInput::statistics()
+        virtual void eventsDropped(int device);
+        virtual void queueDepth(int device, int pending);
+    };
+
+    explicit QJoystickInput(QObject *parent = nullptr);
+    ~QJoystickInput() override;
+
+    virtual Capabilities capabilities() const;
+
+    // Opens the devices present and starts watching for new ones. Devices
+    // found are reported to the sink right away.
+    virtual bool start(EventSink &sink);
+    // Closes all devices, reporting them as disconnected
+    virtual void stop(EventSink &sink);
+
+    // Descriptors that become readable when poll() has work to do. Emit
+    // pollDescriptorsChanged() when the set changes.
+    virtual QList<qintptr> pollDescriptors() const;
+    // Milliseconds between unconditional calls to poll(), -1 for none. Read
+    // again after every poll(), so it may follow the state of the backend.
+    virtual int pollInterval() const;
+    // Reads everything pending without blocking and reports it to the sink
+    virtual void poll(EventSink &sink);
+
+    // Plays a rumble effect of the given length on a device of this
+    // backend, zero magnitudes stop it. Returns false if not supported.
+    virtual bool setRumble(int device, float weakMagnitude, float strongMagnitude, int durationMs);
+
+Q_SIGNALS:
+    void pollDescriptorsChanged();
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(QJoystickInput::Capabilities)
+
 QT_END_NAMESPACE
 
 #endif // QJOYSTICKINPUT_P_H
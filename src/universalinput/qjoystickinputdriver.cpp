@@ -0,0 +1,177 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qjoystickinputdriver_p.h"
+#include "quniversalinput_p.h"
+
+#include <QtCore/QSocketNotifier>
+#include <QtCore/QTimerEvent>
+
+QT_BEGIN_NAMESPACE
+
+QJoystickInputDriver::QJoystickInputDriver(QJoystickInput *backend)
+    : QObject(backend)
+    , m_backend(backend)
+{
+    connect(backend, &QJoystickInput::pollDescriptorsChanged, this, &QJoystickInputDriver::updateNotifiers);
+}
+
+QJoystickInputDriver::~QJoystickInputDriver()
+{
+    qDeleteAll(m_notifiers);
+}
+
+// Backends that are not PollDriven run on their own, there is nothing to
+// start for them.
+bool QJoystickInputDriver::start()
+{
+    if (m_running || !m_backend->capabilities().testFlag(QJoystickInput::PollDriven))
+        return true;
+
+    if (!m_backend->start(*this))
+        return false;
+
+    m_running = true;
+    updateNotifiers();
+    updateTimer();
+    return true;
+}
+
+void QJoystickInputDriver::stop()
+{
+    if (!m_running)
+        return;
+
+    m_running = false;
+    m_timer.stop();
+    m_interval = -1;
+    m_backend->stop(*this);
+    updateNotifiers();
+}
+
+void QJoystickInputDriver::updateNotifiers()
+{
+    // This can run from a notifier's own activated signal, so the old
+    // notifiers are disabled now and deleted later
+    for (QSocketNotifier *notifier : std::as_const(m_notifiers)) {
+        notifier->setEnabled(false);
+        notifier->deleteLater();
+    }
+    m_notifiers.clear();
+
+    if (!m_running)
+        return;
+
+    const QList<qintptr> descriptors = m_backend->pollDescriptors();
+    for (qintptr descriptor : descriptors) {
+        auto notifier = new QSocketNotifier(descriptor, QSocketNotifier::Read, this);
+        connect(notifier, &QSocketNotifier::activated, this, &QJoystickInputDriver::poll);
+        m_notifiers.append(notifier);
+    }
+}
+
+// The interval of a backend can change with its state, like waiting for a
+// device or a segment to appear
+void QJoystickInputDriver::updateTimer()
+{
+    const int interval = m_backend->pollInterval();
+    if (interval == m_interval && (interval < 0 || m_timer.isActive()))
+        return;
+
+    m_interval = interval;
+    if (interval >= 0)
+        m_timer.start(interval, Qt::PreciseTimer, this);
+    else
+        m_timer.stop();
+}
+
+void QJoystickInputDriver::poll()
+{
+    if (!m_running)
+        return;
+    m_backend->poll(*this);
+    if (m_running)
+        updateTimer();
+
+    // The motion samples of the poll are fused together
+    auto d = static_cast<QUniversalInputPrivate *>(QObjectPrivate::get(QUniversalInput::instance()));
+    QMutexLocker locker(&d->mutex);
+    d->processMotion();
+}
+
+void QJoystickInputDriver::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != m_timer.timerId()) {
+        QObject::timerEvent(event);
+        return;
+    }
+    poll();
+}
+
+int QJoystickInputDriver::allocateDevice()
+{
+    return QUniversalInput::instance()->allocateJoyId();
+}
+
+void QJoystickInputDriver::releaseDevice(int device)
+{
+    QUniversalInput::instance()->releaseJoyId(device);
+}
+
+bool QJoystickInputDriver::connectionChanged(int device, bool isConnected, const QString &name, const QString &guid,
+                                             const QString &physicalId)
+{
+    auto input = QUniversalInput::instance();
+    auto d = static_cast<QUniversalInputPrivate *>(QObjectPrivate::get(input));
+    QMutexLocker locker(&d->mutex);
+
+    if (!input->updateJoyConnection(device, isConnected, name, guid, physicalId))
+        return false;
+
+    // Requests for the device, like rumble, are routed to its backend
+    if (isConnected)
+        d->deviceDrivers.insert(device, this);
+    else if (d->deviceDrivers.value(device) == this)
+        d->deviceDrivers.remove(device);
+    return true;
+}
+
+void QJoystickInputDriver::button(int device, JoyButton button, bool isPressed, qint64 timestamp)
+{
+    QUniversalInput::instance()->joyButton(device, button, isPressed, timestamp);
+}
+
+void QJoystickInputDriver::axis(int device, JoyAxis axis, float value, qint64 timestamp)
+{
+    QUniversalInput::instance()->joyAxis(device, axis, value, timestamp);
+}
+
+void QJoystickInputDriver::hat(int device, HatMask value, qint64 timestamp)
+{
+    QUniversalInput::instance()->joyHat(device, value, timestamp);
+}
+
+void QJoystickInputDriver::motion(int device, const QUniversalInput::MotionSample &sample)
+{
+    auto d = static_cast<QUniversalInputPrivate *>(QObjectPrivate::get(QUniversalInput::instance()));
+    QMutexLocker locker(&d->mutex);
+    d->appendMotion(device, sample);
+}
+
+void QJoystickInputDriver::touch(int device, const QUniversalInput::TouchContact *contacts, int count,
+                                 qint64 timestamp)
+{
+    QUniversalInput::instance()->joyTouch(device, contacts, count, timestamp);
+}
+
+void QJoystickInputDriver::eventsDropped(int device)
+{
+    QUniversalInput::instance()->joyEventsDropped(device);
+}
+
+void QJoystickInputDriver::queueDepth(int device, int pending)
+{
+    QUniversalInput::instance()->joyQueueDepth(device, pending);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,74 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QJOYSTICKINPUTDRIVER_P_H
+#define QJOYSTICKINPUTDRIVER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtUniversalInput/private/qtuniversalinputglobal_p.h>
+#include <QtUniversalInput/private/qjoystickinput_p.h>
+
+#include <QtCore/QBasicTimer>
+#include <QtCore/QList>
+
+QT_BEGIN_NAMESPACE
+
+class QSocketNotifier;
+
+// Runs a PollDriven backend on the thread the backend lives on, delivering
+// its events to QUniversalInput. It is a child of the backend, so it moves
+// to the input thread and is destroyed along with it.
+class Q_UNIVERSALINPUT_EXPORT QJoystickInputDriver : public QObject, public QJoystickInput::EventSink
+{
+    Q_OBJECT
+public:
+    explicit QJoystickInputDriver(QJoystickInput *backend);
+    ~QJoystickInputDriver() override;
+
+    QJoystickInput *backend() const { return m_backend; }
+
+    bool start();
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    // QJoystickInput::EventSink
+    int allocateDevice() override;
+    void releaseDevice(int device) override;
+    bool connectionChanged(int device, bool isConnected, const QString &name, const QString &guid,
+                           const QString &physicalId) override;
+    void button(int device, JoyButton button, bool isPressed, qint64 timestamp) override;
+    void axis(int device, JoyAxis axis, float value, qint64 timestamp) override;
+    void hat(int device, HatMask value, qint64 timestamp) override;
+    void motion(int device, const QUniversalInput::MotionSample &sample) override;
+    void touch(int device, const QUniversalInput::TouchContact *contacts, int count, qint64 timestamp) override;
+    void eventsDropped(int device) override;
+    void queueDepth(int device, int pending) override;
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    void updateNotifiers();
+    void updateTimer();
+    void poll();
+
+    QJoystickInput *m_backend;
+    QList<QSocketNotifier *> m_notifiers;
+    QBasicTimer m_timer;
+    int m_interval = -1;
+    bool m_running = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QJOYSTICKINPUTDRIVER_P_H
@@ -6,6 +6,8 @@
 #include "qjoystickinput_p.h"
 
 #include <QtCore/private/qfactoryloader_p.h>
+#include <QtCore/QCborArray>
+#include <QtCore/QCborMap>
 
 QT_BEGIN_NAMESPACE
 
@@ -16,6 +18,23 @@ QStringList QJoystickInputFactory::keys()
     return loader->keyMap().values();
 }
 
+// Keys of the backends loaded when none are configured. Plugins with
+// "OptIn" set in their metadata are only loaded when asked for by key.
+QStringList QJoystickInputFactory::defaultKeys()
+{
+    QStringList keys;
+    const QList<QPluginParsedMetaData> metaData = loader->metaData();
+    for (const QPluginParsedMetaData &plugin : metaData) {
+        const QCborMap map = plugin.value(QtPluginMetaDataKeys::MetaData).toMap();
+        if (map.value(QLatin1StringView("OptIn")).toBool())
+            continue;
+        const QCborArray pluginKeys = map.value(QLatin1StringView("Keys")).toArray();
+        for (const QCborValue &key : pluginKeys)
+            keys.append(key.toString());
+    }
+    return keys;
+}
+
 QJoystickInput *QJoystickInputFactory::create(const QString &key, const QStringList &paramList)
 {
     return qLoadPlugin<QJoystickInput, QJoystickInputPlugin>(loader(), key, paramList);
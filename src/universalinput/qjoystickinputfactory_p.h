@@ -26,6 +26,7 @@ class Q_UNIVERSALINPUT_EXPORT QJoystickInputFactory
 {
 public:
     static QStringList keys();
+    static QStringList defaultKeys();
     static QJoystickInput *create(const QString &key, const QStringList &paramList);
 };
 
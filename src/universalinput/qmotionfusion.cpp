@@ -0,0 +1,196 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmotionfusion_p.h"
+
+#include <algorithm>
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+// Filter gain: how fast the gyroscope estimate is pulled towards the
+// accelerometer. Higher right after reset(), so that the orientation
+// settles within a fraction of a second.
+static constexpr float Beta = 0.1f;
+static constexpr float InitialBeta = 2.5f;
+static constexpr float InitialTime = 0.5f;
+
+// Rest detection: the gyroscope stays within RestDeviation of its recent
+// average and within RestRate of the bias, and the accelerometer reads
+// about 1 g, for RestTime seconds
+static constexpr float SmoothingTimeConstant = 0.2f;
+static constexpr float RestDeviation = 0.03f; // rad/s
+static constexpr float RestRate = 0.3f;
+static constexpr float RestGravityTolerance = 0.1f; // relative
+static constexpr float RestTime = 0.5f;
+// The bias follows the gyroscope at rest with this time constant
+static constexpr float BiasTimeConstant = 1.0f;
+static constexpr float CalibratedTime = 1.0f;
+
+static constexpr float StandardGravity = 9.80665f;
+static constexpr float MinimumNorm = 1e-12f;
+
+QMotionFusion::QMotionFusion()
+{
+    for (int lane = 0; lane < Lanes; lane++)
+        reset(lane);
+}
+
+void QMotionFusion::reset(int lane)
+{
+    m_q0[lane] = 1.0f;
+    m_q1[lane] = m_q2[lane] = m_q3[lane] = 0.0f;
+    m_biasX[lane] = m_biasY[lane] = m_biasZ[lane] = 0.0f;
+    m_smoothX[lane] = m_smoothY[lane] = m_smoothZ[lane] = 0.0f;
+    m_rateX[lane] = m_rateY[lane] = m_rateZ[lane] = 0.0f;
+    m_angleX[lane] = m_angleY[lane] = m_angleZ[lane] = 0.0f;
+    m_time[lane] = m_restTime[lane] = m_calibrationTime[lane] = 0.0f;
+}
+
+// Branches would keep the loop from being vectorized: every lane computes
+// every step, conditions are turned into factors of 0 or 1, and divisions
+// are kept away from 0 rather than skipped.
+void QMotionFusion::update(const Input &input)
+{
+    // A copy cannot overlap the state, which spares the compiler a check
+    const Input in = input;
+    for (int i = 0; i < Lanes; i++) {
+        const float dt = in.dt[i];
+        const float active = float(dt > 0.0f);
+
+        // Rest detection and bias calibration
+        const float smoothing = dt / (SmoothingTimeConstant + dt);
+        m_smoothX[i] += (in.gx[i] - m_smoothX[i]) * smoothing;
+        m_smoothY[i] += (in.gy[i] - m_smoothY[i]) * smoothing;
+        m_smoothZ[i] += (in.gz[i] - m_smoothZ[i]) * smoothing;
+        const float dx = in.gx[i] - m_smoothX[i];
+        const float dy = in.gy[i] - m_smoothY[i];
+        const float dz = in.gz[i] - m_smoothZ[i];
+        const float cx = in.gx[i] - m_biasX[i];
+        const float cy = in.gy[i] - m_biasY[i];
+        const float cz = in.gz[i] - m_biasZ[i];
+        const float accelNorm2 = in.ax[i] * in.ax[i] + in.ay[i] * in.ay[i] + in.az[i] * in.az[i];
+        const float accelNorm = std::sqrt(accelNorm2);
+        const float still = float((dx * dx + dy * dy + dz * dz < RestDeviation * RestDeviation)
+                                  & (cx * cx + cy * cy + cz * cz < RestRate * RestRate)
+                                  & (std::fabs(accelNorm - StandardGravity) < RestGravityTolerance * StandardGravity));
+        // Counts up while still, restarts on motion
+        m_restTime[i] = (m_restTime[i] + dt) * still + m_restTime[i] * (1.0f - active) * (1.0f - still);
+        const float atRest = float(m_restTime[i] >= RestTime);
+        const float learn = atRest * dt / (BiasTimeConstant + dt);
+        m_biasX[i] += (in.gx[i] - m_biasX[i]) * learn;
+        m_biasY[i] += (in.gy[i] - m_biasY[i]) * learn;
+        m_biasZ[i] += (in.gz[i] - m_biasZ[i]) * learn;
+        m_calibrationTime[i] += atRest * dt;
+
+        const float gx = in.gx[i] - m_biasX[i];
+        const float gy = in.gy[i] - m_biasY[i];
+        const float gz = in.gz[i] - m_biasZ[i];
+        m_rateX[i] = active * gx + (1.0f - active) * m_rateX[i];
+        m_rateY[i] = active * gy + (1.0f - active) * m_rateY[i];
+        m_rateZ[i] = active * gz + (1.0f - active) * m_rateZ[i];
+        m_angleX[i] += gx * dt;
+        m_angleY[i] += gy * dt;
+        m_angleZ[i] += gz * dt;
+
+        // Madgwick's IMU update. Rate of change of the orientation from
+        // the gyroscope...
+        const float q0 = m_q0[i];
+        const float q1 = m_q1[i];
+        const float q2 = m_q2[i];
+        const float q3 = m_q3[i];
+        float qDot0 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+        float qDot1 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+        float qDot2 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+        float qDot3 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+        // ...corrected along the gradient that turns the gravity the
+        // orientation implies towards the measured one
+        const float accelValid = float(accelNorm2 > 0.0f);
+        const float accelScale = accelValid / std::max(accelNorm, MinimumNorm);
+        const float ax = in.ax[i] * accelScale;
+        const float ay = in.ay[i] * accelScale;
+        const float az = in.az[i] * accelScale;
+        const float _2q0 = 2.0f * q0;
+        const float _2q1 = 2.0f * q1;
+        const float _2q2 = 2.0f * q2;
+        const float _2q3 = 2.0f * q3;
+        const float _4q0 = 4.0f * q0;
+        const float _4q1 = 4.0f * q1;
+        const float _4q2 = 4.0f * q2;
+        const float _8q1 = 8.0f * q1;
+        const float _8q2 = 8.0f * q2;
+        const float q0q0 = q0 * q0;
+        const float q1q1 = q1 * q1;
+        const float q2q2 = q2 * q2;
+        const float q3q3 = q3 * q3;
+        const float s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+        const float s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1 - _2q0 * ay - _4q1 + _8q1 * q1q1
+                + _8q1 * q2q2 + _4q1 * az;
+        const float s2 = 4.0f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 + _8q2 * q1q1
+                + _8q2 * q2q2 + _4q2 * az;
+        const float s3 = 4.0f * q1q1 * q3 - _2q1 * ax + 4.0f * q2q2 * q3 - _2q2 * ay;
+        const float gradientNorm2 = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+        // No correction without a usable accelerometer reading
+        const float beta = Beta + (InitialBeta - Beta) * float(m_time[i] < InitialTime);
+        const float correction = accelValid * beta / std::sqrt(std::max(gradientNorm2, MinimumNorm));
+        qDot0 -= correction * s0;
+        qDot1 -= correction * s1;
+        qDot2 -= correction * s2;
+        qDot3 -= correction * s3;
+
+        const float n0 = q0 + qDot0 * dt;
+        const float n1 = q1 + qDot1 * dt;
+        const float n2 = q2 + qDot2 * dt;
+        const float n3 = q3 + qDot3 * dt;
+        const float norm = 1.0f / std::sqrt(n0 * n0 + n1 * n1 + n2 * n2 + n3 * n3);
+        m_q0[i] = n0 * norm;
+        m_q1[i] = n1 * norm;
+        m_q2[i] = n2 * norm;
+        m_q3[i] = n3 * norm;
+        m_time[i] += dt;
+    }
+}
+
+QQuaternion QMotionFusion::orientation(int lane) const
+{
+    return QQuaternion(m_q0[lane], m_q1[lane], m_q2[lane], m_q3[lane]);
+}
+
+QVector3D QMotionFusion::gravity(int lane) const
+{
+    const float q0 = m_q0[lane];
+    const float q1 = m_q1[lane];
+    const float q2 = m_q2[lane];
+    const float q3 = m_q3[lane];
+    return QVector3D(2.0f * (q1 * q3 - q0 * q2),
+                     2.0f * (q0 * q1 + q2 * q3),
+                     q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3) * StandardGravity;
+}
+
+QVector3D QMotionFusion::rotationRate(int lane) const
+{
+    return QVector3D(m_rateX[lane], m_rateY[lane], m_rateZ[lane]);
+}
+
+QVector3D QMotionFusion::accumulatedRotation(int lane) const
+{
+    return QVector3D(m_angleX[lane], m_angleY[lane], m_angleZ[lane]);
+}
+
+QVector3D QMotionFusion::gyroscopeBias(int lane) const
+{
+    return QVector3D(m_biasX[lane], m_biasY[lane], m_biasZ[lane]);
+}
+
+bool QMotionFusion::isAtRest(int lane) const
+{
+    return m_restTime[lane] >= RestTime;
+}
+
+bool QMotionFusion::isCalibrated(int lane) const
+{
+    return m_calibrationTime[lane] >= CalibratedTime;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,97 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMOTIONFUSION_P_H
+#define QMOTIONFUSION_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtUniversalInput/private/qtuniversalinputglobal_p.h>
+
+#include <QtGui/QQuaternion>
+#include <QtGui/QVector3D>
+
+QT_BEGIN_NAMESPACE
+
+// Orientation of up to Lanes devices from their accelerometer and gyroscope,
+// with Madgwick's gradient descent filter.
+//
+// The state of each quantity is an array with one entry per device, and a
+// step updates all devices with the same straight-line arithmetic, so the
+// compiler turns the loops into vector instructions. A device without a
+// sample in a step is passed a dt of 0, which leaves its state unchanged.
+//
+// While a device lies still the gyroscope reads its bias, which is then
+// learned and subtracted.
+class Q_UNIVERSALINPUT_EXPORT QMotionFusion
+{
+public:
+    enum { Lanes = 8 };
+
+    struct Input {
+        alignas(32) float gx[Lanes] = {}; // rad/s
+        alignas(32) float gy[Lanes] = {};
+        alignas(32) float gz[Lanes] = {};
+        alignas(32) float ax[Lanes] = {}; // any unit, only the direction is used
+        alignas(32) float ay[Lanes] = {};
+        alignas(32) float az[Lanes] = {};
+        alignas(32) float dt[Lanes] = {}; // seconds, 0 for no sample
+    };
+
+    QMotionFusion();
+
+    void reset(int lane);
+    void update(const Input &input);
+
+    // Rotation from the device frame to a world frame with Z up. The
+    // heading has no reference and drifts.
+    QQuaternion orientation(int lane) const;
+    // Gravity in the device frame, as the accelerometer reads it at rest
+    QVector3D gravity(int lane) const;
+    // Rate of the last step with the bias removed, rad/s
+    QVector3D rotationRate(int lane) const;
+    // Sum of the bias corrected rotation since reset(), in radians about
+    // the device axes. The difference between two frames is the rotation
+    // in between, as gyro aiming needs it.
+    QVector3D accumulatedRotation(int lane) const;
+    QVector3D gyroscopeBias(int lane) const;
+    bool isAtRest(int lane) const;
+    // A bias has been learned since reset()
+    bool isCalibrated(int lane) const;
+
+private:
+    alignas(32) float m_q0[Lanes];
+    alignas(32) float m_q1[Lanes];
+    alignas(32) float m_q2[Lanes];
+    alignas(32) float m_q3[Lanes];
+    alignas(32) float m_biasX[Lanes];
+    alignas(32) float m_biasY[Lanes];
+    alignas(32) float m_biasZ[Lanes];
+    // Low-passed gyroscope, a reading close to it means no motion
+    alignas(32) float m_smoothX[Lanes];
+    alignas(32) float m_smoothY[Lanes];
+    alignas(32) float m_smoothZ[Lanes];
+    alignas(32) float m_rateX[Lanes];
+    alignas(32) float m_rateY[Lanes];
+    alignas(32) float m_rateZ[Lanes];
+    alignas(32) float m_angleX[Lanes];
+    alignas(32) float m_angleY[Lanes];
+    alignas(32) float m_angleZ[Lanes];
+    // Seconds since reset(), still and calibrating
+    alignas(32) float m_time[Lanes];
+    alignas(32) float m_restTime[Lanes];
+    alignas(32) float m_calibrationTime[Lanes];
+};
+
+QT_END_NAMESPACE
+
+#endif // QMOTIONFUSION_P_H
@@ -10,12 +10,36 @@
 #include "quniversalinput.h"
 #include "quniversalinput_p.h"
 #include "qjoystickinput_p.h"
+#include "qjoystickinputdriver_p.h"
 #include "qjoystickinputfactory_p.h"
 #include "qjoydevicemappingparser_p.h"
 #include "qmouseinput_p.h"
 #include "qmouseinputfactory_p.h"
+#include "qinputreplay_p.h"
+#include "qmotionfusion_p.h"
+#if QT_CONFIG(sharedmemory)
+#include "qinputservice_p.h"
+#endif
+
+#include <qtuniversalinput_tracepoints_p.h>
 
 #include <QDateTime>
+#include <QDeadlineTimer>
+#include <QtCore/qalgorithms.h>
+#include <QtCore/QVarLengthArray>
+
+#include <algorithm>
+#include <utility>
+
+#if defined(Q_OS_LINUX)
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -44,22 +68,172 @@ QUniversalInputPrivate::QUniversalInputPrivate() {
 
 QUniversalInputPrivate::~QUniversalInputPrivate()
 {
-    delete joystickInput;
+    delete recorder;
+#if QT_CONFIG(sharedmemory)
+    delete servicePublisher;
+#endif
+    if (inputThread) {
+        // The backend is deleted on its thread once it finishes
+        inputThread->quit();
+        inputThread->wait();
+        delete inputThread;
+    } else {
+        qDeleteAll(joystickInputs);
+    }
+}
+
+static QThread::Priority threadPriorityFromEnvironment(QThread::Priority defaultPriority)
+{
+    static const struct {
+        const char *name;
+        QThread::Priority priority;
+    } priorities[] = {
+        { "idle", QThread::IdlePriority },
+        { "lowest", QThread::LowestPriority },
+        { "low", QThread::LowPriority },
+        { "normal", QThread::NormalPriority },
+        { "high", QThread::HighPriority },
+        { "highest", QThread::HighestPriority },
+        { "timecritical", QThread::TimeCriticalPriority },
+    };
+
+    const QByteArray name = qgetenv("QT_UNIVERSALINPUT_THREAD_PRIORITY").toLower();
+    if (name.isEmpty())
+        return defaultPriority;
+    for (const auto &entry : priorities) {
+        if (name == entry.name)
+            return entry.priority;
+    }
+    qWarning() << "Unknown QT_UNIVERSALINPUT_THREAD_PRIORITY" << name;
+    return defaultPriority;
+}
+
+// Parses CPU lists like "2,3" or "0-3"
+static QList<int> cpusFromString(const QByteArray &string)
+{
+    QList<int> cpus;
+    const QList<QByteArray> ranges = string.split(',');
+    for (const QByteArray &range : ranges) {
+        const qsizetype dash = range.indexOf('-');
+        bool firstOk = false;
+        bool lastOk = false;
+        const int first = range.left(dash == -1 ? range.size() : dash).trimmed().toInt(&firstOk);
+        const int last = dash == -1 ? first : range.mid(dash + 1).trimmed().toInt(&lastOk);
+        if (!firstOk || (dash != -1 && !lastOk) || first < 0 || last < first) {
+            qWarning() << "Invalid CPU list" << string;
+            return {};
+        }
+        for (int cpu = first; cpu <= last; cpu++)
+            cpus.append(cpu);
+    }
+    return cpus;
+}
+
+static QUniversalInput::ThreadScheduling threadSchedulingFromEnvironment(QUniversalInput::ThreadScheduling scheduling)
+{
+    const QByteArray policy = qgetenv("QT_UNIVERSALINPUT_THREAD_SCHED").toLower();
+    if (policy == "fifo")
+        scheduling.policy = QUniversalInput::ThreadScheduling::FifoPolicy;
+    else if (policy == "rr")
+        scheduling.policy = QUniversalInput::ThreadScheduling::RoundRobinPolicy;
+    else if (policy == "other")
+        scheduling.policy = QUniversalInput::ThreadScheduling::DefaultPolicy;
+    else if (!policy.isEmpty())
+        qWarning() << "Unknown QT_UNIVERSALINPUT_THREAD_SCHED" << policy;
+
+    bool ok = false;
+    const int realtimePriority = qEnvironmentVariableIntValue("QT_UNIVERSALINPUT_THREAD_RTPRIO", &ok);
+    if (ok)
+        scheduling.realtimePriority = realtimePriority;
+    const int niceValue = qEnvironmentVariableIntValue("QT_UNIVERSALINPUT_THREAD_NICE", &ok);
+    if (ok)
+        scheduling.niceValue = niceValue;
+    if (qEnvironmentVariableIsSet("QT_UNIVERSALINPUT_THREAD_AFFINITY"))
+        scheduling.cpus = cpusFromString(qgetenv("QT_UNIVERSALINPUT_THREAD_AFFINITY"));
+    return scheduling;
 }
 
 void QUniversalInputPrivate::_q_init()
 {
-    loadMappingDatabase();
+    initialized = true;
+
+    // One process can own the devices and serve the mapped events to the
+    // others, which then need no mapping database of their own
+    const QByteArray serviceMode = qgetenv("QT_UNIVERSALINPUT_SERVICE");
+    const bool attachToService = serviceMode == "attach";
+    if (!serviceMode.isEmpty() && serviceMode != "publish" && !attachToService)
+        qWarning() << "Unknown QT_UNIVERSALINPUT_SERVICE" << serviceMode;
+    if (!attachToService)
+        loadMappingDatabase();
+#if QT_CONFIG(sharedmemory)
+    if (serviceMode == "publish") {
+        servicePublisher = new QInputServicePublisher();
+        if (!servicePublisher->open(QInputService::keyFromEnvironment()))
+            delete std::exchange(servicePublisher, nullptr);
+    }
+#endif
+
+    if (qEnvironmentVariableIntValue("QT_UNIVERSALINPUT_THREAD"))
+        useInputThread = true;
+    inputThreadPriority = threadPriorityFromEnvironment(inputThreadPriority);
+    inputThreadScheduling = threadSchedulingFromEnvironment(inputThreadScheduling);
+
+    // Allows driving the input pipeline with synthetic events only, for
+    // instance in headless benchmarks, without real devices interfering.
+    const bool pluginsDisabled = qEnvironmentVariableIsSet("QT_UNIVERSALINPUT_DISABLE_PLUGINS");
+
+    // Sessions can be recorded for later replay, for instance to reproduce
+    // a bug or to drive a performance regression run.
+    const QString recordFile = qEnvironmentVariable("QT_UNIVERSALINPUT_RECORD");
+    if (!recordFile.isEmpty()) {
+        QInputRecorder::Sources sources = QInputRecorder::MappedEvents;
+        if (qEnvironmentVariableIsSet("QT_UNIVERSALINPUT_RECORD_RAW"))
+            sources |= QInputRecorder::RawEvents;
+        startRecording(recordFile, sources);
+    }
 
-    QStringList keys = QJoystickInputFactory::keys();
-    if (!keys.isEmpty())
-        joystickInput = QJoystickInputFactory::create(keys.first(), QStringList());
+    // Several backends can run side by side, e.g. "linux,replay". By
+    // default a replayed recording takes the place of the first plugin.
+    if (qEnvironmentVariableIsSet("QT_UNIVERSALINPUT_BACKENDS"))
+        joystickBackendKeys = qEnvironmentVariable("QT_UNIVERSALINPUT_BACKENDS").split(u',', Qt::SkipEmptyParts);
+    QStringList keys = joystickBackendKeys;
+    if (keys.isEmpty()) {
+        if (attachToService)
+            keys = QStringList { QStringLiteral("service") };
+        else if (qEnvironmentVariableIsSet("QT_UNIVERSALINPUT_REPLAY"))
+            keys = QStringList { QStringLiteral("replay") };
+        else if (!pluginsDisabled)
+            keys = QJoystickInputFactory::defaultKeys().mid(0, 1);
+    }
+
+    for (const QString &key : std::as_const(keys)) {
+        if (pluginsDisabled && key != QLatin1StringView("replay") && key != QLatin1StringView("service"))
+            continue;
+        auto backend = createJoystickInput(key.trimmed());
+        if (!backend)
+            continue;
+        // Started here, the driver moves to the input thread along with
+        // the backend and picks up from there
+        auto driver = new QJoystickInputDriver(backend);
+        if (!driver->start()) {
+            qWarning() << "Could not start joystick backend" << key;
+            delete backend;
+            continue;
+        }
+        joystickInputs.append(backend);
+        joystickDrivers.append(driver);
+    }
 
     // If we fail to load a plugin, create a dummy joystick input
-    if (!joystickInput)
-        joystickInput = new QJoystickInput();
+    if (joystickInputs.isEmpty()) {
+        joystickInputs.append(new QJoystickInput());
+        joystickDrivers.append(new QJoystickInputDriver(joystickInputs.last()));
+    }
 
-    keys = QMouseInputFactory::keys();
+    if (useInputThread)
+        startInputThread();
+
+    keys = pluginsDisabled ? QStringList() : QMouseInputFactory::keys();
     if (!keys.isEmpty())
         mouseInput = QMouseInputFactory::create(keys.first(), QStringList());
 
@@ -68,6 +242,374 @@ void QUniversalInputPrivate::_q_init()
         mouseInput = new QMouseInput();
 }
 
+QJoystickInput *QUniversalInputPrivate::createJoystickInput(const QString &key)
+{
+    // The replay backend is built in
+    if (key == QLatin1StringView("replay")) {
+        auto replay = new QInputReplay();
+        if (!replay->open(qEnvironmentVariable("QT_UNIVERSALINPUT_REPLAY"))) {
+            delete replay;
+            return nullptr;
+        }
+        const bool fast = qEnvironmentVariableIsSet("QT_UNIVERSALINPUT_REPLAY_FAST");
+        replay->start(fast ? QInputReplay::AsFastAsPossible : QInputReplay::RealTime);
+        return replay;
+    }
+
+    // So is the client of an input service
+    if (key == QLatin1StringView("service")) {
+#if QT_CONFIG(sharedmemory)
+        return new QInputServiceClient(QInputService::keyFromEnvironment());
+#else
+        qWarning() << "The input service needs shared memory support";
+        return nullptr;
+#endif
+    }
+
+    QJoystickInput *backend = QJoystickInputFactory::create(key, QStringList());
+    if (!backend)
+        qWarning() << "Could not load joystick backend" << key;
+    return backend;
+}
+
+// Stops the driven backends on the thread they run on, which reports their
+// devices as disconnected
+void QUniversalInputPrivate::stopJoystickInputs()
+{
+    for (QJoystickInputDriver *driver : std::as_const(joystickDrivers)) {
+        if (driver->thread() == QThread::currentThread() || !driver->thread()->isRunning())
+            driver->stop();
+        else
+            QMetaObject::invokeMethod(driver, &QJoystickInputDriver::stop, Qt::BlockingQueuedConnection);
+    }
+}
+
+// Moves the joystick backend, and with it the mapping, off the thread
+// QUniversalInput lives on, so that a busy GUI thread does not delay input.
+// The button and axis events are still emitted on the thread QUniversalInput
+// lives on, see queueEvent().
+void QUniversalInputPrivate::startInputThread()
+{
+    // Room for the events of a few frames of a busy device
+    pendingEvents.reserve(256);
+    emittingEvents.reserve(256);
+
+    inputThread = new QThread();
+    inputThread->setObjectName(QStringLiteral("QUniversalInput"));
+    // All backends share the thread. They are driven by timers and socket
+    // notifiers, so none of them blocks the others.
+    for (QJoystickInput *backend : std::as_const(joystickInputs)) {
+        backend->moveToThread(inputThread);
+        QObject::connect(inputThread, &QThread::finished, backend, &QObject::deleteLater);
+    }
+
+    // Runs on the input thread before its event loop starts
+    const QUniversalInput::ThreadScheduling scheduling = inputThreadScheduling;
+    QObject::connect(inputThread, &QThread::started, inputThread, [scheduling] {
+        QUniversalInput::applyThreadScheduling(scheduling);
+    }, Qt::DirectConnection);
+
+    inputThread->start(inputThreadPriority);
+}
+
+// Devices may be fed without ever connecting, like the virtual pads of QML.
+// Their entry is created by the first event, later ones find it without
+// allocating.
+QUniversalInput::Joypad &QUniversalInputPrivate::joypadFor(int device)
+{
+    auto it = joypadNames.find(device);
+    if (it == joypadNames.end())
+        it = joypadNames.emplace(device);
+    return *it;
+}
+
+void QUniversalInputPrivate::setEventTimestamp(qint64 timestamp)
+{
+    // Backends that do not know when an event happened get the time it
+    // reached us, which is as close as we can get.
+    eventTimestamp = timestamp ? timestamp : QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+}
+
+// Called with the mutex held. Returns false if the event is to be emitted
+// right away, which is the case on the thread QUniversalInput lives on.
+bool QUniversalInputPrivate::queueEvent(QUniversalInput::JoyType type, int device, int index, float value)
+{
+    Q_Q(QUniversalInput);
+    if (!inputThread || QThread::currentThread() == q->thread())
+        return false;
+
+    pendingEvents.push_back({ eventTimestamp, device, type, index, value });
+    // One delivery is posted per batch, the events queued until it runs
+    // are emitted with it
+    if (!std::exchange(deliveryPosted, true))
+        QMetaObject::invokeMethod(q, [this] { deliverPendingEvents(); }, Qt::QueuedConnection);
+    return true;
+}
+
+void QUniversalInputPrivate::deliverPendingEvents()
+{
+    Q_Q(QUniversalInput);
+    // The events are emitted without the mutex, so that receivers do not
+    // hold up the input thread. Whatever it queues meanwhile is picked up
+    // by the next round, no delivery is posted until the queue is empty.
+    for (;;) {
+        {
+            QMutexLocker locker(&mutex);
+            emittingEvents.clear();
+            std::swap(pendingEvents, emittingEvents);
+            if (emittingEvents.empty()) {
+                deliveryPosted = false;
+                return;
+            }
+        }
+
+        for (const QUniversalInputPendingEvent &event : std::as_const(emittingEvents)) {
+            emittedTimestamp = event.timestamp;
+            countEmitted(event.device, event.timestamp);
+            if (event.type == QUniversalInput::TypeButton)
+                Q_EMIT q->joyButtonEvent(event.device, JoyButton(event.index), event.value != 0.0f);
+            else
+                Q_EMIT q->joyAxisEvent(event.device, JoyAxis(event.index), event.value);
+        }
+    }
+}
+
+void QUniversalInputDeviceCounters::reset(qint64 now)
+{
+    since.store(now, std::memory_order_relaxed);
+    for (auto &count : events)
+        count.store(0, std::memory_order_relaxed);
+    for (auto &count : latency)
+        count.store(0, std::memory_order_relaxed);
+    droppedEvents.store(0, std::memory_order_relaxed);
+    queueHighWaterMark.store(0, std::memory_order_relaxed);
+    mappingMisses.store(0, std::memory_order_relaxed);
+    reportInterval.store(0.0f, std::memory_order_relaxed);
+    reportJitter.store(0.0f, std::memory_order_relaxed);
+    lastReport = 0;
+}
+
+QUniversalInputDeviceRegistry::~QUniversalInputDeviceRegistry()
+{
+    for (auto &chunk : m_chunks)
+        delete[] chunk.load(std::memory_order_relaxed);
+}
+
+QUniversalInputDevice *QUniversalInputDeviceRegistry::find(int id) const
+{
+    if (id < 0 || id >= QUniversalInput::JoypadsMax)
+        return nullptr;
+    QUniversalInputDevice *chunk = m_chunks[id / ChunkSize].load(std::memory_order_acquire);
+    return chunk ? &chunk[id % ChunkSize] : nullptr;
+}
+
+QUniversalInputDevice *QUniversalInputDeviceRegistry::get(int id)
+{
+    if (id < 0 || id >= QUniversalInput::JoypadsMax)
+        return nullptr;
+    auto &chunk = m_chunks[id / ChunkSize];
+    QUniversalInputDevice *devices = chunk.load(std::memory_order_relaxed);
+    if (!devices) {
+        devices = new QUniversalInputDevice[ChunkSize];
+        chunk.store(devices, std::memory_order_release);
+        const int end = (id / ChunkSize + 1) * ChunkSize;
+        if (end > m_capacity.load(std::memory_order_relaxed))
+            m_capacity.store(end, std::memory_order_release);
+    }
+    return &devices[id % ChunkSize];
+}
+
+QUniversalInputDeviceCounters *QUniversalInputPrivate::counters(int device)
+{
+    QUniversalInputDevice *state = devices.find(device);
+    return state ? &state->counters : nullptr;
+}
+
+void QUniversalInputPrivate::countEvent(int device, QUniversalInput::JoyType type)
+{
+    auto c = counters(device);
+    if (!c)
+        return;
+
+    c->events[type].fetch_add(1, std::memory_order_relaxed);
+
+    // Events of one report share its timestamp. Longer gaps between reports
+    // mean the device was idle, not that it reports slowly.
+    constexpr qint64 MaxReportInterval = 100 * 1000 * 1000;
+    const qint64 interval = eventTimestamp - c->lastReport;
+    if (interval <= 0)
+        return;
+
+    if (c->lastReport && interval < MaxReportInterval) {
+        float mean = c->reportInterval.load(std::memory_order_relaxed);
+        float jitter = c->reportJitter.load(std::memory_order_relaxed);
+        if (mean == 0.0f)
+            mean = interval;
+        mean += (interval - mean) / 16.0f;
+        jitter += (qAbs(interval - mean) - jitter) / 16.0f;
+        c->reportInterval.store(mean, std::memory_order_relaxed);
+        c->reportJitter.store(jitter, std::memory_order_relaxed);
+    }
+    c->lastReport = eventTimestamp;
+}
+
+void QUniversalInputPrivate::countEmitted(int device, qint64 timestamp)
+{
+    auto c = counters(device);
+    if (!c)
+        return;
+
+    const qint64 latency = (QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs() - timestamp) / 1000;
+    const int bucket = latency > 0 ? 64 - qCountLeadingZeroBits(quint64(latency)) : 0;
+    c->latency[qMin(bucket, int(QUniversalInput::DeviceStatistics::LatencyBuckets) - 1)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void QUniversalInputPrivate::countMappingMiss(int device)
+{
+    if (auto c = counters(device))
+        c->mappingMisses.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool QUniversalInputPrivate::startRecording(const QString &fileName, QInputRecorder::Sources sources)
+{
+    QMutexLocker locker(&mutex);
+    stopRecording();
+
+    auto newRecorder = new QInputRecorder(sources);
+    if (!newRecorder->open(fileName)) {
+        delete newRecorder;
+        return false;
+    }
+    recorder = newRecorder;
+
+    // Devices connected before the recording started must be known on replay
+    const qint64 now = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+    for (auto it = joypadNames.cbegin(); it != joypadNames.cend(); ++it) {
+        if (it->isConnected)
+            recorder->recordConnection(now, it.key(), true, it->name, it->uid);
+    }
+    return true;
+}
+
+void QUniversalInputPrivate::stopRecording()
+{
+    QMutexLocker locker(&mutex);
+    delete std::exchange(recorder, nullptr);
+}
+
+void QUniversalInputPrivate::appendMotion(int device, const QUniversalInput::MotionSample &sample)
+{
+    QUniversalInputDevice *state = devices.find(device);
+    if (!state)
+        return;
+    setEventTimestamp(sample.timestamp);
+
+    auto &ring = state->motionRing;
+    if (!ring) {
+        ring = std::make_unique<QUniversalInputMotionRing>();
+        const size_t groups = size_t(device / QMotionFusion::Lanes + 1);
+        if (motionFusion.size() < groups)
+            motionFusion.resize(groups);
+    }
+    QUniversalInput::MotionSample &stored = ring->samples[ring->written % QUniversalInput::MotionSamplesMax];
+    stored = sample;
+    stored.timestamp = eventTimestamp;
+    ring->written++;
+    motionPending = true;
+
+    acceleration = sample.acceleration;
+    if (!sample.magnetometer.isNull())
+        magnetometer = sample.magnetometer;
+}
+
+// Longest gap between two samples the fusion integrates over, in seconds
+static constexpr float MaxMotionStep = 0.1f;
+
+// Runs the samples appended since the last call through the fusion, one
+// sample of every device per step, and announces them. Only the groups of
+// connected devices are visited.
+void QUniversalInputPrivate::processMotion()
+{
+    Q_Q(QUniversalInput);
+    if (!motionPending)
+        return;
+    motionPending = false;
+
+    constexpr int Lanes = QMotionFusion::Lanes;
+    QVarLengthArray<int, 16> fused;
+    for (qsizetype next = 0; next < activeDevices.size();) {
+        const int group = activeDevices[next] / Lanes;
+        // The connected devices of the group, activeDevices is sorted
+        QUniversalInputMotionRing *rings[Lanes] = {};
+        bool anyRing = false;
+        for (; next < activeDevices.size() && activeDevices[next] / Lanes == group; next++) {
+            const int device = activeDevices[next];
+            QUniversalInputMotionRing *ring = devices.find(device)->motionRing.get();
+            if (!ring)
+                continue;
+            // Samples overwritten before they were fused are skipped
+            if (ring->written - ring->fused > quint64(QUniversalInput::MotionSamplesMax))
+                ring->fused = ring->written - QUniversalInput::MotionSamplesMax;
+            rings[device % Lanes] = ring;
+            anyRing = true;
+        }
+        if (!anyRing)
+            continue;
+        QMotionFusion &fusion = motionFusion[group];
+
+        bool fusedLane[Lanes] = {};
+        for (;;) {
+            QMotionFusion::Input input;
+            QUniversalInput::MotionSample *samples[Lanes] = {};
+            bool any = false;
+            for (int lane = 0; lane < Lanes; lane++) {
+                QUniversalInputMotionRing *ring = rings[lane];
+                if (!ring || ring->fused == ring->written)
+                    continue;
+                auto &sample = ring->samples[ring->fused % QUniversalInput::MotionSamplesMax];
+                input.gx[lane] = sample.gyroscope.x();
+                input.gy[lane] = sample.gyroscope.y();
+                input.gz[lane] = sample.gyroscope.z();
+                input.ax[lane] = sample.acceleration.x();
+                input.ay[lane] = sample.acceleration.y();
+                input.az[lane] = sample.acceleration.z();
+                // The first sample only starts the clock
+                if (ring->lastFused)
+                    input.dt[lane] = qBound(0.0f, (sample.timestamp - ring->lastFused) / 1e9f, MaxMotionStep);
+                ring->lastFused = sample.timestamp;
+                ring->fused++;
+                samples[lane] = &sample;
+                any = true;
+            }
+            if (!any)
+                break;
+
+            fusion.update(input);
+            for (int lane = 0; lane < Lanes; lane++) {
+                if (!samples[lane])
+                    continue;
+                samples[lane]->orientation = fusion.orientation(lane);
+                samples[lane]->gravity = fusion.gravity(lane);
+                samples[lane]->gyroscope -= fusion.gyroscopeBias(lane);
+                gravity = samples[lane]->gravity;
+                gyroscope = samples[lane]->gyroscope;
+                fusedLane[lane] = true;
+            }
+        }
+
+        for (int lane = 0; lane < Lanes; lane++) {
+            if (fusedLane[lane] && !rings[lane]->notified) {
+                rings[lane]->notified = true;
+                fused.append(group * Lanes + lane);
+            }
+        }
+    }
+
+    // Once per batch of samples, not per sample
+    for (int device : std::as_const(fused))
+        Q_EMIT q->joyMotionEvent(device);
+}
+
 void QUniversalInputPrivate::loadMappingDatabase()
 {
     QJoyDeviceMappingParser parser(QString::fromUtf8(":/qt-project.org/qtuniversalinput/gamecontrollerdb.txt"));
@@ -129,6 +671,8 @@ QUniversalInput::QUniversalInput()
 
 QUniversalInput::~QUniversalInput()
 {
+    Q_D(QUniversalInput);
+    d->stopJoystickInputs();
 }
 
 QUniversalInput *QUniversalInput::instance()
@@ -140,6 +684,7 @@ QUniversalInput *QUniversalInput::instance()
 QString QUniversalInput::getJoyName(int device) const
 {
     Q_D(const QUniversalInput);
+    QMutexLocker locker(&d->mutex);
     // If the device does not exist, an empty Joypad
     // Struct should be returned, so name will be empty
     const auto joypad = d->joypadNames[device];
@@ -149,15 +694,25 @@ QString QUniversalInput::getJoyName(int device) const
 bool QUniversalInput::isJoyConnected(int device) const
 {
     Q_D(const QUniversalInput);
+    QMutexLocker locker(&d->mutex);
     // If the device does not exist, an empty Joypad
     // Struct should be returned
     const auto joypad = d->joypadNames[device];
     return joypad.isConnected;
 }
 
+// The ids of the connected devices, in ascending order
+QList<int> QUniversalInput::connectedJoypads() const
+{
+    Q_D(const QUniversalInput);
+    QMutexLocker locker(&d->mutex);
+    return d->activeDevices;
+}
+
 bool QUniversalInput::isGamepad(int device) const
 {
     Q_D(const QUniversalInput);
+    QMutexLocker locker(&d->mutex);
     // If the device does not exist, an empty Joypad
     // Struct should be returned
     const auto joypad = d->joypadNames[device];
@@ -165,17 +720,171 @@ bool QUniversalInput::isGamepad(int device) const
     return joypad.mapping != -1;
 }
 
+// Copy of the state of a device, safe to call from any thread
+QUniversalInput::Joypad QUniversalInput::joypad(int device) const
+{
+    Q_D(const QUniversalInput);
+    QMutexLocker locker(&d->mutex);
+    return d->joypadNames.value(device);
+}
+
+// Runs the joystick backend and the device mapping on a dedicated thread.
+// Can also be enabled by setting QT_UNIVERSALINPUT_THREAD=1, with the
+// priority given by QT_UNIVERSALINPUT_THREAD_PRIORITY. Only takes effect
+// when called before the event loop starts and the backends are loaded.
+void QUniversalInput::setInputThreadEnabled(bool enabled, QThread::Priority priority)
+{
+    Q_D(QUniversalInput);
+    if (d->initialized) {
+        qWarning("QUniversalInput: the input thread must be configured before the event loop starts");
+        return;
+    }
+    d->useInputThread = enabled;
+    d->inputThreadPriority = priority;
+}
+
+bool QUniversalInput::isInputThreadEnabled() const
+{
+    Q_D(const QUniversalInput);
+    return d->inputThread != nullptr;
+}
+
+// Real-time scheduling, nice value and CPU affinity of the input thread.
+// The QT_UNIVERSALINPUT_THREAD_SCHED (fifo, rr or other),
+// QT_UNIVERSALINPUT_THREAD_RTPRIO, QT_UNIVERSALINPUT_THREAD_NICE and
+// QT_UNIVERSALINPUT_THREAD_AFFINITY (e.g. "2,3" or "0-3") environment
+// variables take precedence. Like setInputThreadEnabled(), only takes
+// effect when called before the event loop starts.
+void QUniversalInput::setInputThreadScheduling(const ThreadScheduling &scheduling)
+{
+    Q_D(QUniversalInput);
+    if (d->initialized) {
+        qWarning("QUniversalInput: the input thread must be configured before the event loop starts");
+        return;
+    }
+    d->inputThreadScheduling = scheduling;
+}
+
+// Applies the scheduling to the calling thread. Settings the process lacks
+// the privileges for, typically CAP_SYS_NICE, are skipped with a warning and
+// the thread keeps running with what could be applied. Returns whether
+// everything was applied. Only supported on Linux.
+bool QUniversalInput::applyThreadScheduling(const ThreadScheduling &scheduling)
+{
+#if defined(Q_OS_LINUX)
+    bool applied = true;
+    bool realtime = false;
+
+    if (scheduling.policy != ThreadScheduling::DefaultPolicy) {
+        const int policy = scheduling.policy == ThreadScheduling::FifoPolicy ? SCHED_FIFO : SCHED_RR;
+        sched_param param = {};
+        param.sched_priority = qBound(sched_get_priority_min(policy), scheduling.realtimePriority,
+                                      sched_get_priority_max(policy));
+        const int error = pthread_setschedparam(pthread_self(), policy, &param);
+        realtime = !error;
+        if (error) {
+            qWarning() << "QUniversalInput: could not enable real-time scheduling, falling back to the nice value:"
+                       << strerror(error);
+            applied = false;
+        }
+    }
+
+    if (!realtime && scheduling.niceValue) {
+        // On Linux the nice value is per thread
+        if (setpriority(PRIO_PROCESS, id_t(syscall(SYS_gettid)), scheduling.niceValue) == -1) {
+            qWarning() << "QUniversalInput: could not set nice value:" << strerror(errno);
+            applied = false;
+        }
+    }
+
+    if (!scheduling.cpus.isEmpty()) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (int cpu : scheduling.cpus) {
+            if (cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &cpuSet);
+        }
+        const int error = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+        if (error) {
+            qWarning() << "QUniversalInput: could not set CPU affinity:" << strerror(error);
+            applied = false;
+        }
+    }
+
+    return applied;
+#else
+    if (scheduling.policy == ThreadScheduling::DefaultPolicy && !scheduling.niceValue && scheduling.cpus.isEmpty())
+        return true;
+    qWarning("QUniversalInput: thread scheduling options are not supported on this platform");
+    return false;
+#endif
+}
+
 int QUniversalInput::getUnusedJoyId() {
     Q_D(QUniversalInput);
-    for (int i = 0; i < JoypadsMax; i++)
-        if (!d->joypadNames.contains(i) || !d->joypadNames[i].isConnected)
+    QMutexLocker locker(&d->mutex);
+    for (int i = 0; i < JoypadsMax; i++) {
+        if ((!d->joypadNames.contains(i) || !d->joypadNames[i].isConnected) && !d->reservedJoyIds.contains(i)) {
+            d->devices.get(i);
             return i;
+        }
+    }
     return -1;
 }
 
-void QUniversalInput::updateJoyConnection(int index, bool isConnected, const QString &name, const QString &guid) {
+// Like getUnusedJoyId(), but reserves the slot until the device connected
+// to it disconnects or releaseJoyId() is called. Backends running
+// concurrently must use this, so that they never hand out the same slot.
+int QUniversalInput::allocateJoyId()
+{
     Q_D(QUniversalInput);
     QMutexLocker locker(&d->mutex);
+    const int id = getUnusedJoyId();
+    if (id != -1)
+        d->reservedJoyIds.insert(id);
+    return id;
+}
+
+void QUniversalInput::releaseJoyId(int index)
+{
+    Q_D(QUniversalInput);
+    QMutexLocker locker(&d->mutex);
+    d->reservedJoyIds.remove(index);
+}
+
+// Backends that load after this is called are not affected. Can also be
+// set with QT_UNIVERSALINPUT_BACKENDS, which takes precedence. The key
+// "replay" plays back the recording named by QT_UNIVERSALINPUT_REPLAY,
+// "service" presents the devices of the input service of another process.
+void QUniversalInput::setJoystickBackends(const QStringList &keys)
+{
+    Q_D(QUniversalInput);
+    if (d->initialized) {
+        qWarning("QUniversalInput: the joystick backends must be configured before the event loop starts");
+        return;
+    }
+    d->joystickBackendKeys = keys;
+}
+
+// Returns false if the device is ignored, because another backend already
+// reported the same physicalId. The slot is released in that case.
+bool QUniversalInput::updateJoyConnection(int index, bool isConnected, const QString &name, const QString &guid,
+                                          const QString &physicalId)
+{
+    Q_D(QUniversalInput);
+    QMutexLocker locker(&d->mutex);
+
+    if (isConnected && !physicalId.isEmpty()) {
+        for (auto it = d->joypadNames.cbegin(); it != d->joypadNames.cend(); ++it) {
+            if (it.key() != index && it->isConnected && it->physicalId == physicalId) {
+                d->reservedJoyIds.remove(index);
+                return false;
+            }
+        }
+    }
+
+    if (d->recorder)
+        d->recorder->recordConnection(QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs(), index, isConnected, name, guid);
 
     Joypad js;
     js.name = isConnected ? name : QString();
@@ -199,26 +908,55 @@ void QUniversalInput::updateJoyConnection(int index, bool isConnected, const QSt
             }
         }
         js.mapping = mapping;
+        js.physicalId = physicalId;
+        // Backends replaying ids of another process skip allocateJoyId()
+        if (QUniversalInputDevice *state = d->devices.get(index)) {
+            state->counters.reset(QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs());
+            const auto it = std::lower_bound(d->activeDevices.begin(), d->activeDevices.end(), index);
+            if (it == d->activeDevices.end() || *it != index)
+                d->activeDevices.insert(it, index);
+        }
     } else {
         js.isConnected = false;
+        d->reservedJoyIds.remove(index);
         for (int i = 0; i < (int)JoyButton::MAX; i++) {
             JoyButton c = _combine_device((JoyButton)i, index);
             d->joystickButtonsPressed.remove(c);
         }
         for (int i = 0; i < (int)JoyAxis::MAX; i++)
             setJoyAxis(index, (JoyAxis)i, 0.0f);
+        if (QUniversalInputDevice *state = d->devices.find(index)) {
+            if (state->motionRing) {
+                state->motionRing.reset();
+                d->motionFusion[index / QMotionFusion::Lanes].reset(index % QMotionFusion::Lanes);
+            }
+            state->touchCount = 0;
+        }
+        d->activeDevices.removeOne(index);
 
     }
     d->joypadNames[index] = js;
+#if QT_CONFIG(sharedmemory)
+    // Clients get the name from the mapping database
+    if (d->servicePublisher)
+        d->servicePublisher->publishConnection(QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs(), index,
+                                               isConnected, js.name, js.uid);
+#endif
 
     Q_EMIT joyConnectionChanged(index, isConnected);
+    return true;
 }
 
-void QUniversalInput::joyButton(int device, JoyButton button, bool isPressed) {
+void QUniversalInput::joyButton(int device, JoyButton button, bool isPressed, qint64 timestamp) {
     Q_D(QUniversalInput);
     QMutexLocker locker(&d->mutex);
 
-    Joypad &joy = d->joypadNames[device];
+    d->setEventTimestamp(timestamp);
+    if (d->recorder)
+        d->recorder->recordButton(d->eventTimestamp, device, button, isPressed, QInputRecorder::RawEvents);
+    d->countEvent(device, TypeButton);
+
+    Joypad &joy = d->joypadFor(device);
     Q_ASSERT(int(button) < int(JoyButton::MAX));
 
     if (joy.lastButtons[size_t(button)] == isPressed)
@@ -231,6 +969,9 @@ void QUniversalInput::joyButton(int device, JoyButton button, bool isPressed) {
     }
 
     JoyEvent map = mappedButtonEvent(d->mappingDatabase[joy.mapping], button);
+    Q_TRACE(QUniversalInput_mappedButtonEvent, device, int(button), map.type, map.index);
+    if (map.type == TypeMax)
+        d->countMappingMiss(device);
 
     if (map.type == TypeButton) {
         sendButtonEvent(device, JoyButton(map.index), isPressed);
@@ -241,14 +982,19 @@ void QUniversalInput::joyButton(int device, JoyButton button, bool isPressed) {
         sendAxisEvent(device, JoyAxis(map.index), isPressed ? map.value : 0.0f);
 }
 
-void QUniversalInput::joyAxis(int device, JoyAxis axis, float value)
+void QUniversalInput::joyAxis(int device, JoyAxis axis, float value, qint64 timestamp)
 {
     Q_D(QUniversalInput);
     QMutexLocker locker(&d->mutex);
 
+    d->setEventTimestamp(timestamp);
+    if (d->recorder)
+        d->recorder->recordAxis(d->eventTimestamp, device, axis, value, QInputRecorder::RawEvents);
+    d->countEvent(device, TypeAxis);
+
     Q_ASSERT(int(axis) < int(JoyAxis::MAX));
 
-    Joypad &joy = d->joypadNames[device];
+    Joypad &joy = d->joypadFor(device);
 
     if (joy.lastAxis[size_t(axis)] == value)
         return;
@@ -261,6 +1007,9 @@ void QUniversalInput::joyAxis(int device, JoyAxis axis, float value)
     }
 
     JoyEvent map = mappedAxisEvent(d->mappingDatabase[joy.mapping], axis, value);
+    Q_TRACE(QUniversalInput_mappedAxisEvent, device, int(axis), value, map.type, map.index);
+    if (map.type == TypeMax)
+        d->countMappingMiss(device);
 
     if (map.type == TypeButton) {
         bool pressed = map.value > 0.5;
@@ -302,12 +1051,17 @@ void QUniversalInput::joyAxis(int device, JoyAxis axis, float value)
     }
 }
 
-void QUniversalInput::joyHat(int device, HatMask value)
+void QUniversalInput::joyHat(int device, HatMask value, qint64 timestamp)
 {
     Q_D(QUniversalInput);
     QMutexLocker locker(&d->mutex);
 
-    const Joypad &joy = d->joypadNames[device];
+    d->setEventTimestamp(timestamp);
+    if (d->recorder)
+        d->recorder->recordHat(d->eventTimestamp, device, value);
+    d->countEvent(device, TypeHat);
+
+    Joypad &joy = d->joypadFor(device);
 
     JoyEvent map[size_t(HatDirection::Max)];
     map[size_t(HatDirection::Up)].type = TypeButton;
@@ -330,7 +1084,7 @@ void QUniversalInput::joyHat(int device, HatMask value)
     if (joy.mapping != -1)
         mappedHatEvents(d->mappingDatabase[joy.mapping], HatDirection(0), map);
 
-    int cur_val = d->joypadNames[device].hatCurrent;
+    int cur_val = joy.hatCurrent;
 
     for (int hat_direction = 0, hat_mask = 1; hat_direction < (int)HatDirection::Max; hat_direction++, hat_mask <<= 1) {
         if ((int(value) & hat_mask) != (cur_val & hat_mask)) {
@@ -341,12 +1095,243 @@ void QUniversalInput::joyHat(int device, HatMask value)
         }
     }
 
-    d->joypadNames[device].hatCurrent = int(value);
+    joy.hatCurrent = int(value);
+}
+
+// For backends reporting without QJoystickInputDriver, which fuses the
+// samples of a whole poll together
+void QUniversalInput::joyMotion(int device, const MotionSample &sample)
+{
+    Q_D(QUniversalInput);
+    QMutexLocker locker(&d->mutex);
+    d->appendMotion(device, sample);
+    d->processMotion();
+}
+
+// Takes the contacts of a touchpad frame. A contact is the same finger as
+// in the previous frame if it has the same slot and id.
+void QUniversalInput::joyTouch(int device, const TouchContact *contacts, int count, qint64 timestamp)
+{
+    Q_D(QUniversalInput);
+    QMutexLocker locker(&d->mutex);
+
+    QUniversalInputDevice *state = d->devices.find(device);
+    if (!state)
+        return;
+    d->setEventTimestamp(timestamp);
+
+    TouchContact previous[TouchContactsMax];
+    const int previousCount = state->touchCount;
+    std::copy(state->touchContacts, state->touchContacts + previousCount, previous);
+
+    state->touchCount = 0;
+    for (int i = 0; i < count && state->touchCount < TouchContactsMax; i++) {
+        const TouchContact &contact = contacts[i];
+        if (contact.slot < 0 || contact.slot >= TouchContactsMax)
+            continue;
+
+        VelocityTrack &track = state->touchVelocityTrack[contact.slot];
+        const auto last = std::find_if(previous, previous + previousCount, [&contact](const TouchContact &c) {
+            return c.slot == contact.slot && c.id == contact.id;
+        });
+        if (last != previous + previousCount)
+            track.update(contact.position - last->position);
+        else
+            track.reset();
+
+        TouchContact &stored = state->touchContacts[state->touchCount++];
+        stored = contact;
+        stored.velocity = track.velocity;
+    }
+
+    Q_EMIT joyTouchEvent(device);
+}
+
+// Time of the event being delivered, in nanoseconds of the QDeadlineTimer
+// monotonic clock. Only meaningful inside joyButtonEvent()/joyAxisEvent(),
+// which are emitted on the thread QUniversalInput lives on.
+qint64 QUniversalInput::eventTimestamp() const
+{
+    Q_D(const QUniversalInput);
+    return d->emittedTimestamp;
+}
+
+// Called by backends when they lost events of the device
+void QUniversalInput::joyEventsDropped(int device)
+{
+    Q_D(QUniversalInput);
+    if (auto c = d->counters(device))
+        c->droppedEvents.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Called by backends with the number of events they found pending for the
+// device, to track how far behind the device they are
+void QUniversalInput::joyQueueDepth(int device, int pendingEvents)
+{
+    Q_D(QUniversalInput);
+    auto c = d->counters(device);
+    if (!c)
+        return;
+
+    int highWaterMark = c->queueHighWaterMark.load(std::memory_order_relaxed);
+    while (pendingEvents > highWaterMark
+           && !c->queueHighWaterMark.compare_exchange_weak(highWaterMark, pendingEvents, std::memory_order_relaxed)) {
+    }
+}
+
+// Snapshot of the statistics of every device connected since start up.
+// Does not block the input pipeline, so values of a device may be from
+// slightly different points in time.
+QList<QUniversalInput::DeviceStatistics> QUniversalInput::statistics() const
+{
+    Q_D(const QUniversalInput);
+    const qint64 now = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+
+    QList<DeviceStatistics> result;
+    const int capacity = d->devices.capacity();
+    for (int i = 0; i < capacity; i++) {
+        const QUniversalInputDevice *state = d->devices.find(i);
+        if (!state)
+            continue;
+        const auto &c = state->counters;
+        const qint64 since = c.since.load(std::memory_order_relaxed);
+        if (!since)
+            continue;
+
+        DeviceStatistics stats;
+        stats.device = i;
+        stats.buttonEvents = c.events[TypeButton].load(std::memory_order_relaxed);
+        stats.axisEvents = c.events[TypeAxis].load(std::memory_order_relaxed);
+        stats.hatEvents = c.events[TypeHat].load(std::memory_order_relaxed);
+
+        const float seconds = qMax<qint64>(1, now - since) / 1e9f;
+        stats.buttonEventsPerSecond = stats.buttonEvents / seconds;
+        stats.axisEventsPerSecond = stats.axisEvents / seconds;
+        stats.hatEventsPerSecond = stats.hatEvents / seconds;
+
+        for (int b = 0; b < DeviceStatistics::LatencyBuckets; b++)
+            stats.latencyHistogram[b] = c.latency[b].load(std::memory_order_relaxed);
+
+        stats.droppedEvents = c.droppedEvents.load(std::memory_order_relaxed);
+        stats.queueHighWaterMark = c.queueHighWaterMark.load(std::memory_order_relaxed);
+        stats.mappingMisses = c.mappingMisses.load(std::memory_order_relaxed);
+
+        const float interval = c.reportInterval.load(std::memory_order_relaxed);
+        stats.pollingRate = interval > 0.0f ? 1e9f / interval : 0.0f;
+        stats.pollingJitter = c.reportJitter.load(std::memory_order_relaxed) / 1e6f;
+        result.append(stats);
+    }
+    return result;
+}
+
+bool QUniversalInput::hasMotionSensors(int device) const
+{
+    Q_D(const QUniversalInput);
+    QMutexLocker locker(&d->mutex);
+    const QUniversalInputDevice *state = d->devices.find(device);
+    return state && state->motionRing;
+}
+
+// Returns the samples of the device reported after *sequence, oldest first,
+// and advances *sequence past them. Start with 0. Samples are kept for
+// MotionSamplesMax reports; a reader that falls further behind loses the
+// oldest, which shows as a sequence advancing by more than the samples
+// returned. joyMotionEvent() is emitted again once samples were read.
+QList<QUniversalInput::MotionSample> QUniversalInput::motionSamples(int device, quint64 *sequence) const
+{
+    Q_D(const QUniversalInput);
+    QMutexLocker locker(&d->mutex);
+
+    QList<MotionSample> samples;
+    const QUniversalInputDevice *state = d->devices.find(device);
+    if (!state || !state->motionRing)
+        return samples;
+
+    // Samples are handed out once the fusion has seen them
+    QUniversalInputMotionRing *ring = state->motionRing.get();
+    ring->notified = false;
+    const quint64 oldest = ring->fused > quint64(MotionSamplesMax) ? ring->fused - MotionSamplesMax : 0;
+    // Also covers a reader holding the sequence of a device since disconnected
+    if (*sequence > ring->fused)
+        *sequence = 0;
+    quint64 first = qMax(*sequence, oldest);
+    samples.reserve(qsizetype(ring->fused - first));
+    for (; first < ring->fused; first++)
+        samples.append(ring->samples[first % MotionSamplesMax]);
+    *sequence = ring->fused;
+    return samples;
+}
+
+// The output of the sensor fusion for the device after its latest sample.
+// For gyro aiming, the difference of accumulatedRotation between two frames
+// is the rotation in between.
+QUniversalInput::MotionState QUniversalInput::motionState(int device) const
+{
+    Q_D(const QUniversalInput);
+    QMutexLocker locker(&d->mutex);
+
+    MotionState state;
+    const QUniversalInputDevice *deviceState = d->devices.find(device);
+    if (!deviceState || !deviceState->motionRing)
+        return state;
+
+    const QMotionFusion &fusion = d->motionFusion[device / QMotionFusion::Lanes];
+    const int lane = device % QMotionFusion::Lanes;
+    state.orientation = fusion.orientation(lane);
+    state.gravity = fusion.gravity(lane);
+    state.rotationRate = fusion.rotationRate(lane);
+    state.accumulatedRotation = fusion.accumulatedRotation(lane);
+    state.gyroscopeBias = fusion.gyroscopeBias(lane);
+    state.atRest = fusion.isAtRest(lane);
+    state.calibrated = fusion.isCalibrated(lane);
+    return state;
+}
+
+// The contacts of the latest touchpad frame of the device, in slot order
+QList<QUniversalInput::TouchContact> QUniversalInput::touchContacts(int device) const
+{
+    Q_D(const QUniversalInput);
+    QMutexLocker locker(&d->mutex);
+    const QUniversalInputDevice *state = d->devices.find(device);
+    if (!state)
+        return {};
+    return QList<TouchContact>(state->touchContacts, state->touchContacts + state->touchCount);
+}
+
+// The latest motion readings of whichever device reported last, gravity
+// and gyroscope as the fusion estimates them
+QVector3D QUniversalInput::getGravity() const
+{
+    Q_D(const QUniversalInput);
+    QMutexLocker locker(&d->mutex);
+    return d->gravity;
+}
+
+QVector3D QUniversalInput::getAccelerometer() const
+{
+    Q_D(const QUniversalInput);
+    QMutexLocker locker(&d->mutex);
+    return d->acceleration;
+}
+
+QVector3D QUniversalInput::getGyroscope() const
+{
+    Q_D(const QUniversalInput);
+    QMutexLocker locker(&d->mutex);
+    return d->gyroscope;
+}
+
+QVector3D QUniversalInput::getMagnetometer() const
+{
+    Q_D(const QUniversalInput);
+    QMutexLocker locker(&d->mutex);
+    return d->magnetometer;
 }
 
 QVector2D QUniversalInput::getJoyVibrationStrength(int device)
 {
     Q_D(QUniversalInput);
+    QMutexLocker locker(&d->mutex);
     if (d->joystickVibrations.contains(device))
         return QVector2D(d->joystickVibrations[device].weakMagnitude, d->joystickVibrations[device].strongMagnitude);
     else
@@ -356,6 +1341,7 @@ QVector2D QUniversalInput::getJoyVibrationStrength(int device)
 float QUniversalInput::getJoyVibrationDuration(int device)
 {
     Q_D(QUniversalInput);
+    QMutexLocker locker(&d->mutex);
     if (d->joystickVibrations.contains(device))
         return d->joystickVibrations[device].duration;
     else
@@ -365,6 +1351,7 @@ float QUniversalInput::getJoyVibrationDuration(int device)
 quint64 QUniversalInput::getJoyVibrationTimestamp(int device)
 {
     Q_D(QUniversalInput);
+    QMutexLocker locker(&d->mutex);
     if (d->joystickVibrations.contains(device))
         return d->joystickVibrations[device].timestamp;
     else
@@ -378,6 +1365,17 @@ void QUniversalInput::addForce(int deivce, QVector2D strength, float duration) {
     d->joystickVibrations[deivce].strongMagnitude = strength.y();
     d->joystickVibrations[deivce].duration = duration; // sec
     d->joystickVibrations[deivce].timestamp = QDateTime::currentMSecsSinceEpoch();
+
+    // Driven backends play the effect themselves, the others poll the
+    // vibration state
+    QJoystickInputDriver *driver = d->deviceDrivers.value(deivce);
+    if (driver && driver->backend()->capabilities().testFlag(QJoystickInput::Rumble)) {
+        QJoystickInput *backend = driver->backend();
+        const int durationMs = qRound(duration * 1000.0f);
+        QMetaObject::invokeMethod(backend, [backend, deivce, strength, durationMs] {
+            backend->setRumble(deivce, strength.x(), strength.y(), durationMs);
+        });
+    }
 }
 
 void QUniversalInput::setJoyAxis(int device, JoyAxis axis, float value)
@@ -391,18 +1389,36 @@ void QUniversalInput::setJoyAxis(int device, JoyAxis axis, float value)
 
 void QUniversalInput::sendButtonEvent(int device, JoyButton index, bool pressed)
 {
-    Q_UNUSED(device);
-    Q_UNUSED(index);
-    Q_UNUSED(pressed);
+    Q_TRACE_SCOPE(QUniversalInput_sendButtonEvent, device, int(index), pressed);
+    Q_D(QUniversalInput);
+    if (d->recorder)
+        d->recorder->recordButton(d->eventTimestamp, device, index, pressed, QInputRecorder::MappedEvents);
+#if QT_CONFIG(sharedmemory)
+    if (d->servicePublisher)
+        d->servicePublisher->publishButton(d->eventTimestamp, device, index, pressed);
+#endif
+    if (d->queueEvent(TypeButton, device, int(index), pressed ? 1.0f : 0.0f))
+        return;
+    d->emittedTimestamp = d->eventTimestamp;
+    d->countEmitted(device, d->eventTimestamp);
     Q_EMIT joyButtonEvent(device, index, pressed);
     // qDebug() << "Button event" << device << int(index) << pressed;
 }
 
 void QUniversalInput::sendAxisEvent(int device, JoyAxis axis, float value)
 {
-    Q_UNUSED(device);
-    Q_UNUSED(axis);
-    Q_UNUSED(value);
+    Q_TRACE_SCOPE(QUniversalInput_sendAxisEvent, device, int(axis), value);
+    Q_D(QUniversalInput);
+    if (d->recorder)
+        d->recorder->recordAxis(d->eventTimestamp, device, axis, value, QInputRecorder::MappedEvents);
+#if QT_CONFIG(sharedmemory)
+    if (d->servicePublisher)
+        d->servicePublisher->publishAxis(d->eventTimestamp, device, axis, value);
+#endif
+    if (d->queueEvent(TypeAxis, device, int(axis), value))
+        return;
+    d->emittedTimestamp = d->eventTimestamp;
+    d->countEmitted(device, d->eventTimestamp);
     // qDebug() << "Axis event" << device << int(axis) << value;
     Q_EMIT joyAxisEvent(device, axis, value);
 }
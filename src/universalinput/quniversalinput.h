@@ -13,7 +13,10 @@
 #include <QtCore/QObject>
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QString>
+#include <QtCore/QThread>
+#include <QtGui/QQuaternion>
 #include <QtGui/QVector2D>
+#include <QtGui/QVector3D>
 #include <QtUniversalInput/qtuniversalinputglobal.h>
 #include <QtGui/QMouseEvent>
 
@@ -98,7 +101,12 @@ class Q_UNIVERSALINPUT_EXPORT QUniversalInput : public QObject
     Q_OBJECT
 public:
     enum {
-        JoypadsMax = 16,
+        // Device ids are below this. They are handed out lowest first, and
+        // the state of an id is allocated when it is first used.
+        JoypadsMax = 1024,
+        // Motion samples kept per device, about a second at the native rate
+        MotionSamplesMax = 1024,
+        TouchContactsMax = 10,
     };
 
     struct Action {
@@ -136,6 +144,9 @@ public:
         HatMask lastHat = HatMask::Center;
         int mapping = -1;
         int hatCurrent = 0;
+        // Backend specific identity of the physical device, e.g. the evdev
+        // phys path, used to drop duplicates reported by several backends
+        QString physicalId;
     };
 
     enum JoyType {
@@ -193,20 +204,125 @@ public:
         QVector<JoyBinding> bindings;
     };
 
+    struct DeviceStatistics {
+        enum { LatencyBuckets = 24 };
+
+        int device = -1;
+        // Events received from the backend since the device connected
+        quint64 buttonEvents = 0;
+        quint64 axisEvents = 0;
+        quint64 hatEvents = 0;
+        float buttonEventsPerSecond = 0.0f;
+        float axisEventsPerSecond = 0.0f;
+        float hatEventsPerSecond = 0.0f;
+        // Time from the event timestamp of the backend until the mapped
+        // event is emitted. Bucket n counts latencies of less than 2^n
+        // microseconds not counted in a lower bucket, the last one everything above.
+        quint64 latencyHistogram[LatencyBuckets] = {};
+        // Times the backend reported losing events, e.g. SYN_DROPPED on Linux
+        quint64 droppedEvents = 0;
+        // Most events the backend had pending for the device at once
+        int queueHighWaterMark = 0;
+        // Events the device mapping has no binding for
+        quint64 mappingMisses = 0;
+        // Estimated report rate of the device in Hz, and the mean deviation
+        // of the report interval in milliseconds
+        float pollingRate = 0.0f;
+        float pollingJitter = 0.0f;
+    };
+
+    struct ThreadScheduling {
+        enum Policy {
+            DefaultPolicy,
+            FifoPolicy,       // SCHED_FIFO
+            RoundRobinPolicy, // SCHED_RR
+        };
+
+        Policy policy = DefaultPolicy;
+        // 1 to 99, for FifoPolicy and RoundRobinPolicy
+        int realtimePriority = 1;
+        // Nice value, also used when real-time scheduling is not permitted.
+        // 0 leaves it unchanged
+        int niceValue = 0;
+        // CPUs the thread may run on, empty for no restriction
+        QList<int> cpus;
+    };
+
+    // A reading of the motion sensors of a device, in the frame of the
+    // device as the kernel or platform reports it
+    struct MotionSample {
+        qint64 timestamp = 0;   // monotonic nanoseconds
+        QVector3D acceleration; // m/s^2, including gravity
+        QVector3D gyroscope;    // rad/s, the estimated bias removed
+        QVector3D magnetometer; // microtesla, null if the device has none
+        // Filled in by the sensor fusion
+        QQuaternion orientation; // device to world with Z up, the heading drifts
+        QVector3D gravity;       // m/s^2 in the device frame
+    };
+
+    // A finger on the touchpad of a device
+    struct TouchContact {
+        int id = -1;           // stays the same while the finger touches
+        int slot = 0;          // below TouchContactsMax, reused once the finger lifts
+        QVector2D position;    // 0 to 1 across the touchpad, from the top left
+        QVector2D velocity;    // touchpad sizes per second
+        float pressure = 0.0f; // 0 to 1, 0 if not reported
+    };
+
+    struct MotionState {
+        QQuaternion orientation;
+        QVector3D gravity;
+        QVector3D rotationRate;        // rad/s, the bias removed
+        QVector3D accumulatedRotation; // radians about the device axes since connecting
+        QVector3D gyroscopeBias;       // rad/s, learned while the device lies still
+        bool atRest = false;
+        bool calibrated = false;       // a bias has been learned
+    };
+
     static QUniversalInput *instance();
 
     QString getJoyName(int device) const;
     bool isJoyConnected(int device) const;
+    QList<int> connectedJoypads() const;
     bool isGamepad(int device) const;
+    Joypad joypad(int device) const;
+
+    void setInputThreadEnabled(bool enabled, QThread::Priority priority = QThread::HighPriority);
+    bool isInputThreadEnabled() const;
+    void setInputThreadScheduling(const ThreadScheduling &scheduling);
+    void setJoystickBackends(const QStringList &keys);
+    static bool applyThreadScheduling(const ThreadScheduling &scheduling);
 
     // API used by platform specific plugins
     // Joypad/Joystick/Gamepads
     int getUnusedJoyId();
-    void updateJoyConnection(int index, bool isConnected, const QString &name, const QString &guid = QString());
-
-    void joyButton(int device, JoyButton button, bool isPressed);
-    void joyAxis(int device, JoyAxis axis, float value);
-    void joyHat(int device, HatMask value);
+    int allocateJoyId();
+    void releaseJoyId(int index);
+    bool updateJoyConnection(int index, bool isConnected, const QString &name, const QString &guid = QString(),
+                             const QString &physicalId = QString());
+
+    void joyButton(int device, JoyButton button, bool isPressed, qint64 timestamp = 0);
+    void joyAxis(int device, JoyAxis axis, float value, qint64 timestamp = 0);
+    void joyHat(int device, HatMask value, qint64 timestamp = 0);
+    void joyMotion(int device, const MotionSample &sample);
+    void joyTouch(int device, const TouchContact *contacts, int count, qint64 timestamp = 0);
+
+    qint64 eventTimestamp() const;
+
+    void joyEventsDropped(int device);
+    void joyQueueDepth(int device, int pendingEvents);
+
+    QList<DeviceStatistics> statistics() const;
+
+    // Motion sensors
+    bool hasMotionSensors(int device) const;
+    QList<MotionSample> motionSamples(int device, quint64 *sequence) const;
+    MotionState motionState(int device) const;
+    QList<TouchContact> touchContacts(int device) const;
+    QVector3D getGravity() const;
+    QVector3D getAccelerometer() const;
+    QVector3D getGyroscope() const;
+    QVector3D getMagnetometer() const;
 
     // Force Feedback
     QVector2D getJoyVibrationStrength(int device);
@@ -224,6 +340,8 @@ Q_SIGNALS:
     void joyConnectionChanged(int index, bool isConnected);
     void joyButtonEvent(int device, JoyButton button, bool isPressed);
     void joyAxisEvent(int device, JoyAxis axis, float value);
+    void joyMotionEvent(int device);
+    void joyTouchEvent(int device);
 
     void mouseDisabledChanged();
     void mouseMovedWithDeltas(const QVector2D& deltas);
@@ -241,6 +359,9 @@ private:
     JoyEvent mappedAxisEvent(const JoyDeviceMapping &mapping, JoyAxis axis, float inValue);
     void mappedHatEvents(const JoyDeviceMapping &mapping, HatDirection hat, JoyEvent events[size_t(HatDirection::Max)]);
 
+    friend class QInputReplay;
+    friend class QInputServiceClient;
+
     Q_DECLARE_PRIVATE(QUniversalInput)
     Q_DISABLE_COPY(QUniversalInput)
 };
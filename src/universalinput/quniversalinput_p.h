@@ -18,6 +18,8 @@
 #include <QtUniversalInput/private/qtuniversalinputglobal_p.h>
 
 #include <QtUniversalInput/quniversalinput.h>
+#include <QtUniversalInput/private/qinputrecorder_p.h>
+#include <QtUniversalInput/private/qmotionfusion_p.h>
 
 
 #include <QtCore/private/qobject_p.h>
@@ -27,11 +29,97 @@
 #include <QtGui/QVector2D>
 #include <QtCore/QHash>
 #include <QtCore/QRecursiveMutex>
+#include <QtCore/QThread>
+
+#include <atomic>
+#include <memory>
+#include <vector>
 
 
 QT_BEGIN_NAMESPACE
 class QJoystickInput;
+class QJoystickInputDriver;
 class QMouseInput;
+class QInputServicePublisher;
+
+// Statistics of a device. Updated with the QUniversalInput mutex held, but
+// atomic so that they can be read without taking it.
+struct QUniversalInputDeviceCounters
+{
+    std::atomic<qint64> since { 0 }; // nanoseconds, 0 if never connected
+    std::atomic<quint64> events[QUniversalInput::TypeMax] = {};
+    std::atomic<quint64> latency[QUniversalInput::DeviceStatistics::LatencyBuckets] = {};
+    std::atomic<quint64> droppedEvents { 0 };
+    std::atomic<int> queueHighWaterMark { 0 };
+    std::atomic<quint64> mappingMisses { 0 };
+    // Report interval average and mean deviation in nanoseconds
+    std::atomic<float> reportInterval { 0.0f };
+    std::atomic<float> reportJitter { 0.0f };
+    qint64 lastReport = 0;
+
+    void reset(qint64 now);
+};
+
+// The latest motion samples of a device, so that consumers can process
+// every one of them and not only the state at the time they look
+struct QUniversalInputMotionRing
+{
+    QUniversalInput::MotionSample samples[QUniversalInput::MotionSamplesMax];
+    quint64 written = 0;
+    // Samples up to here went through the fusion and are complete
+    quint64 fused = 0;
+    qint64 lastFused = 0;
+    // joyMotionEvent() was emitted and nobody read the samples since
+    bool notified = false;
+};
+
+// The state of one device id
+struct QUniversalInputDevice
+{
+    QUniversalInputDeviceCounters counters;
+    // Allocated when the device reports its first sample
+    std::unique_ptr<QUniversalInputMotionRing> motionRing;
+    // The contacts of the latest touchpad frame, and the velocity of each slot
+    QUniversalInput::TouchContact touchContacts[QUniversalInput::TouchContactsMax];
+    int touchCount = 0;
+    QUniversalInput::VelocityTrack touchVelocityTrack[QUniversalInput::TouchContactsMax];
+};
+
+// The device state, allocated ChunkSize ids at a time as the ids get used.
+// Chunks are never moved or freed before shutdown, so that find() can run
+// without the mutex, as the statistics do.
+class QUniversalInputDeviceRegistry
+{
+public:
+    enum { ChunkSize = 16, Chunks = QUniversalInput::JoypadsMax / ChunkSize };
+
+    QUniversalInputDeviceRegistry() = default;
+    ~QUniversalInputDeviceRegistry();
+    Q_DISABLE_COPY_MOVE(QUniversalInputDeviceRegistry)
+
+    // nullptr for an id that was never used
+    QUniversalInputDevice *find(int id) const;
+    // Allocates the state of the id if needed, with the mutex held
+    QUniversalInputDevice *get(int id);
+    // Ids at and above this have no state
+    int capacity() const { return m_capacity.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<QUniversalInputDevice *> m_chunks[Chunks] = {};
+    std::atomic<int> m_capacity { 0 };
+};
+
+// A mapped event of the input thread, waiting to be emitted on the thread
+// QUniversalInput lives on
+struct QUniversalInputPendingEvent
+{
+    qint64 timestamp;
+    int device;
+    QUniversalInput::JoyType type;
+    int index;
+    float value;
+};
+
 class QUniversalInputPrivate : public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QUniversalInput)
@@ -43,7 +131,15 @@ public:
     // private slots
     void _q_init();
 
-    QJoystickInput *joystickInput = nullptr;
+    // Joystick backends, they share the device slots
+    QList<QJoystickInput *> joystickInputs;
+    QStringList joystickBackendKeys;
+    QJoystickInput *createJoystickInput(const QString &key);
+    QSet<int> reservedJoyIds;
+    // One per backend, and the driver each connected device came from
+    QList<QJoystickInputDriver *> joystickDrivers;
+    QHash<int, QJoystickInputDriver *> deviceDrivers;
+    void stopJoystickInputs();
     QMouseInput *mouseInput = nullptr;
 
 
@@ -55,6 +151,15 @@ public:
     QVector3D acceleration;
     QVector3D magnetometer;
     QVector3D gyroscope;
+    QUniversalInputDeviceRegistry devices;
+    // Connected device ids in ascending order, for the work done per poll
+    QList<int> activeDevices;
+    // One per QMotionFusion::Lanes device ids, grown with the ids reporting
+    // samples
+    std::vector<QMotionFusion> motionFusion;
+    bool motionPending = false;
+    void appendMotion(int device, const QUniversalInput::MotionSample &sample);
+    void processMotion();
 
     QHash<QString, QUniversalInput::Action> actionState;
 
@@ -64,18 +169,56 @@ public:
     QHash<int, QUniversalInput::VibrationInfo> joystickVibrations;
 
     QUniversalInput::VelocityTrack mouseVelocityTrack;
-    QHash<int, QUniversalInput::VelocityTrack> touchVelocityTrack;
     QHash<int, QUniversalInput::Joypad> joypadNames;
+    QUniversalInput::Joypad &joypadFor(int device);
     int fallbackMapping = -1;
 
     QVector<QUniversalInput::JoyDeviceMapping> mappingDatabase;
 
-    QRecursiveMutex mutex;
+    // Guards the device state, which backends may update from the input thread
+    mutable QRecursiveMutex mutex;
+
+    // Optional thread the joystick backend and the mapping run on
+    QThread *inputThread = nullptr;
+    bool useInputThread = false;
+    QThread::Priority inputThreadPriority = QThread::HighPriority;
+    QUniversalInput::ThreadScheduling inputThreadScheduling;
+    bool initialized = false;
+    void startInputThread();
+
+    // Monotonic time in nanoseconds of the event being processed, and of
+    // the event being emitted
+    qint64 eventTimestamp = 0;
+    qint64 emittedTimestamp = 0;
+    void setEventTimestamp(qint64 timestamp);
+
+    // Mapped events of the input thread. They are emitted in batches on the
+    // thread QUniversalInput lives on, instead of through queued signals
+    // that allocate for every event and receiver. The buffers keep their
+    // capacity, so the input path stops allocating once warmed up.
+    std::vector<QUniversalInputPendingEvent> pendingEvents;
+    std::vector<QUniversalInputPendingEvent> emittingEvents;
+    bool deliveryPosted = false;
+    bool queueEvent(QUniversalInput::JoyType type, int device, int index, float value);
+    void deliverPendingEvents();
+
+    QUniversalInputDeviceCounters *counters(int device);
+    void countEvent(int device, QUniversalInput::JoyType type);
+    void countEmitted(int device, qint64 timestamp);
+    void countMappingMiss(int device);
 
     // mouse disable
     bool mouseDisabled = false;
     // mouse disable
 
+    // Records the events passing through, see qinputrecording_p.h
+    QInputRecorder *recorder = nullptr;
+    bool startRecording(const QString &fileName, QInputRecorder::Sources sources);
+    void stopRecording();
+
+    // Serves the mapped events to other processes, see qinputservice_p.h
+    QInputServicePublisher *servicePublisher = nullptr;
+
 private:
     void loadMappingDatabase();
 };
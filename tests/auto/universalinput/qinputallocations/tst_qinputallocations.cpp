@@ -0,0 +1,333 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "testpads.h"
+
+#include <QtTest/QTest>
+#include <QtCore/QThread>
+#include <QtUniversalInput/QActionStore>
+#include <QtUniversalInput/QUniversalInput>
+#include <QtUniversalInput/private/qjoystickinput_p.h>
+#include <QtUniversalInput/private/qjoystickinputdriver_p.h>
+
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+using namespace Qt::Literals::StringLiterals;
+
+// Only the thread that enabled counting is counted
+static thread_local bool countingAllocations = false;
+static thread_local qint64 allocations = 0;
+
+static inline void countAllocation()
+{
+    if (countingAllocations)
+        ++allocations;
+}
+
+#if defined(__GLIBC__)
+// Qt containers allocate through malloc() and not through operator new, so
+// the allocation functions of the C library are interposed. Operator new of
+// the standard library calls malloc() and is counted by that.
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *p, std::size_t size);
+
+void *malloc(std::size_t size) noexcept
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void *calloc(std::size_t count, std::size_t size) noexcept
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *p, std::size_t size) noexcept
+{
+    countAllocation();
+    return __libc_realloc(p, size);
+}
+}
+#else
+// Without a way to interpose malloc(), only operator new is counted, which
+// misses the allocations of Qt containers
+void *operator new(std::size_t size)
+{
+    countAllocation();
+    void *p = std::malloc(size ? size : 1);
+    if (!p)
+        std::abort();
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+#endif
+
+class AllocationCounter
+{
+public:
+    AllocationCounter()
+    {
+        allocations = 0;
+        countingAllocations = true;
+    }
+    ~AllocationCounter() { countingAllocations = false; }
+
+    qint64 count() const { return allocations; }
+};
+
+// Feeds QUniversalInput directly, as QML and applications do
+struct DirectSink
+{
+    void button(int device, JoyButton button, bool isPressed, qint64 timestamp)
+    {
+        QUniversalInput::instance()->joyButton(device, button, isPressed, timestamp);
+    }
+    void axis(int device, JoyAxis axis, float value, qint64 timestamp)
+    {
+        QUniversalInput::instance()->joyAxis(device, axis, value, timestamp);
+    }
+    void hat(int device, HatMask value, qint64 timestamp)
+    {
+        QUniversalInput::instance()->joyHat(device, value, timestamp);
+    }
+};
+
+// Every event changes the state of the device, so none is dropped as a
+// repeat. The sink is a DirectSink or the EventSink of a backend.
+template <typename Sink>
+static void feedEvents(Sink &sink, int device, int events)
+{
+    for (int i = 0; i < events; i++) {
+        const bool on = (i / 3) % 2 == 0;
+        switch (i % 3) {
+        case 0:
+            sink.button(device, JoyButton::A, on, 0);
+            break;
+        case 1:
+            sink.axis(device, JoyAxis::LeftX, on ? 0.5f : -0.5f, 0);
+            break;
+        default:
+            sink.hat(device, on ? HatMask::Up : HatMask::Center, 0);
+            break;
+        }
+    }
+}
+
+// A PollDriven backend with one device, which reports the events it was
+// given on the next poll
+class TestJoystickInput : public QJoystickInput
+{
+public:
+    TestJoystickInput(const QString &name, const QString &guid) : m_name(name), m_guid(guid) { }
+
+    Capabilities capabilities() const override { return PollDriven; }
+
+    bool start(EventSink &sink) override
+    {
+        m_device = sink.allocateDevice();
+        return m_device != -1 && sink.connectionChanged(m_device, true, m_name, m_guid, QString());
+    }
+
+    void stop(EventSink &sink) override
+    {
+        sink.connectionChanged(m_device, false, QString(), QString(), QString());
+        sink.releaseDevice(m_device);
+        m_device = -1;
+    }
+
+    int pollInterval() const override { return -1; }
+
+    void poll(EventSink &sink) override
+    {
+        feedEvents(sink, m_device, m_events);
+        m_events = 0;
+    }
+
+    int device() const { return m_device; }
+    void setEvents(int events) { m_events = events; }
+
+private:
+    QString m_name;
+    QString m_guid;
+    int m_device = -1;
+    int m_events = 0;
+};
+
+// Events fed per measurement
+static constexpr int Events = 10000;
+// Events fed before, state allocated on first use is fine
+static constexpr int WarmupEvents = 300;
+
+// How the events reach QUniversalInput
+enum class Path {
+    Direct,
+    // Direct, with a QActionStore matching them against its actions
+    ActionStore,
+    // Through the driver of a PollDriven backend
+    Backend,
+};
+
+class tst_QInputAllocations : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void steadyState_data();
+    void steadyState();
+    void inputThread();
+
+private:
+    int m_mappedDevice = -1;
+    int m_unmappedDevice = -1;
+    qint64 m_received = 0;
+};
+
+void tst_QInputAllocations::initTestCase()
+{
+    // Only synthetic events, with the input thread running so that events
+    // of other threads take the batched delivery
+    qputenv("QT_UNIVERSALINPUT_DISABLE_PLUGINS", "1");
+    qputenv("QT_UNIVERSALINPUT_THREAD", "1");
+
+    auto input = loadUniversalInput();
+    QVERIFY(input->isInputThreadEnabled());
+
+    m_mappedDevice = connectTestPad(true);
+    QVERIFY(m_mappedDevice != -1);
+    QVERIFY(input->isGamepad(m_mappedDevice));
+
+    m_unmappedDevice = connectTestPad(false);
+    QVERIFY(m_unmappedDevice != -1);
+    QVERIFY(!input->isGamepad(m_unmappedDevice));
+
+    connect(input, &QUniversalInput::joyButtonEvent, this, [this] { ++m_received; });
+    connect(input, &QUniversalInput::joyAxisEvent, this, [this] { ++m_received; });
+}
+
+void tst_QInputAllocations::steadyState_data()
+{
+    QTest::addColumn<bool>("mapped");
+    QTest::addColumn<Path>("path");
+
+    QTest::newRow("mapped") << true << Path::Direct;
+    QTest::newRow("unmapped") << false << Path::Direct;
+    QTest::newRow("mapped, action store") << true << Path::ActionStore;
+    QTest::newRow("unmapped, action store") << false << Path::ActionStore;
+    QTest::newRow("mapped, backend") << true << Path::Backend;
+    QTest::newRow("unmapped, backend") << false << Path::Backend;
+}
+
+void tst_QInputAllocations::steadyState()
+{
+    QFETCH(bool, mapped);
+    QFETCH(Path, path);
+
+    std::unique_ptr<QActionStore> store;
+    int actions = 0;
+    if (path == Path::ActionStore) {
+        store = std::make_unique<QActionStore>();
+        store->registerAction(QActionStore::ActionBuilder(u"jump"_s)
+                                      .addButton(QActionStore::Controller::All, JoyButton::A)
+                                      .build());
+        store->registerAction(QActionStore::ActionBuilder(u"moveRight"_s)
+                                      .addAxis(QActionStore::Controller::All, JoyAxis::LeftX,
+                                               QActionStore::AxisDirection::Right, 0.2f)
+                                      .build());
+        store->registerAction(QActionStore::ActionBuilder(u"menuUp"_s)
+                                      .addButton(QActionStore::Controller::All, JoyButton::DpadUp)
+                                      .build());
+        connect(store.get(), &QActionStore::actionEvent, store.get(), [&] { ++actions; });
+    }
+
+    // The backend is not added to QUniversalInput, the test polls it
+    std::unique_ptr<TestJoystickInput> backend;
+    QJoystickInputDriver *driver = nullptr;
+    if (path == Path::Backend) {
+        backend = mapped ? std::make_unique<TestJoystickInput>(MappedPadName, MappedPadGuid)
+                         : std::make_unique<TestJoystickInput>(UnmappedPadName, UnmappedPadGuid);
+        driver = new QJoystickInputDriver(backend.get());
+        QVERIFY(driver->start());
+        QCOMPARE(QUniversalInput::instance()->isGamepad(backend->device()), mapped);
+    }
+
+    DirectSink direct;
+    auto feed = [&](int events) {
+        if (path == Path::Backend) {
+            backend->setEvents(events);
+            backend->poll(*driver);
+        } else {
+            feedEvents(direct, mapped ? m_mappedDevice : m_unmappedDevice, events);
+        }
+    };
+
+    feed(WarmupEvents);
+
+    m_received = 0;
+    qint64 count = 0;
+    {
+        AllocationCounter counter;
+        feed(Events);
+        count = counter.count();
+    }
+    if (driver)
+        driver->stop();
+
+    QVERIFY(m_received >= Events / 3 * 2);
+    if (store)
+        QVERIFY(actions > 0);
+    QCOMPARE(count, 0);
+}
+
+// Events of the input thread are emitted on the thread of QUniversalInput
+// in batches. Only posting the delivery of a batch may allocate.
+void tst_QInputAllocations::inputThread()
+{
+    qint64 producerAllocations = 0;
+    auto produce = [&] {
+        std::unique_ptr<QThread> thread(QThread::create([&] {
+            DirectSink direct;
+            AllocationCounter counter;
+            feedEvents(direct, m_mappedDevice, Events);
+            producerAllocations = counter.count();
+        }));
+        thread->start();
+        thread->wait();
+    };
+
+    // Grows both event buffers of QUniversalInput to the size of a batch
+    for (int i = 0; i < 2; i++) {
+        produce();
+        QCoreApplication::processEvents();
+    }
+
+    m_received = 0;
+    produce();
+    qint64 deliveryAllocations = 0;
+    {
+        AllocationCounter counter;
+        QCoreApplication::processEvents();
+        deliveryAllocations = counter.count();
+    }
+
+    QVERIFY(m_received >= Events / 3 * 2);
+    QVERIFY2(producerAllocations <= 4, QByteArray::number(producerAllocations));
+    QCOMPARE(deliveryAllocations, 0);
+}
+
+QTEST_GUILESS_MAIN(tst_QInputAllocations)
+#include "tst_qinputallocations.moc"
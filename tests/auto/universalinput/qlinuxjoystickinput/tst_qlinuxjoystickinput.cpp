@@ -0,0 +1,117 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "testpads.h"
+#include "uinputpad.h"
+
+#include <QtTest/QTest>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtUniversalInput/QUniversalInput>
+
+#include <malloc.h>
+#include <unistd.h>
+
+using namespace Qt::Literals::StringLiterals;
+
+// Cycles before the baseline is taken, for state allocated on first use
+static constexpr int WarmupCycles = 20;
+static constexpr int SoakCycles = 1000;
+// A leak of 64 bytes per cycle is above this
+static constexpr qint64 MemoryTolerance = 64 * 1024;
+
+static qsizetype openFileDescriptors()
+{
+    return QDir(u"/proc/self/fd"_s).entryList(QDir::AllEntries | QDir::System | QDir::NoDotAndDotDot).size();
+}
+
+// Bytes of heap in use. Without mallinfo2() the resident size, which moves
+// in whole pages.
+static qint64 memoryInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    return qint64(mallinfo2().uordblks);
+#else
+    QFile statm(u"/proc/self/statm"_s);
+    if (!statm.open(QIODevice::ReadOnly))
+        return 0;
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    return fields.size() > 1 ? fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE) : 0;
+#endif
+}
+
+class tst_QLinuxJoystickInput : public QObject
+{
+    Q_OBJECT
+
+public:
+    static void initMain();
+
+private slots:
+    void initTestCase();
+    void hotplugSoak();
+};
+
+void tst_QLinuxJoystickInput::initMain()
+{
+    UInputPad::selectBackend();
+}
+
+void tst_QLinuxJoystickInput::initTestCase()
+{
+    if (!UInputPad::isAvailable())
+        QSKIP("Needs write access to /dev/uinput");
+
+    loadUniversalInput();
+}
+
+// Connects and disconnects a pad over and over, pressing a button each time.
+// Neither file descriptors nor memory may pile up in the backend.
+void tst_QLinuxJoystickInput::hotplugSoak()
+{
+    auto input = QUniversalInput::instance();
+    const QByteArray phys = "qt-uinput-soak";
+
+    int device = -1;
+    int releases = 0;
+    QObject receiver;
+    connect(input, &QUniversalInput::joyConnectionChanged, &receiver, [&](int id, bool isConnected) {
+        if (isConnected && input->joypad(id).physicalId == QLatin1StringView(phys))
+            device = id;
+    });
+    connect(input, &QUniversalInput::joyButtonEvent, &receiver, [&](int id, JoyButton button, bool isPressed) {
+        if (id == device && button == JoyButton::A && !isPressed)
+            releases++;
+    });
+
+    UInputPad pad;
+    qsizetype fds = 0;
+    qint64 memory = 0;
+    for (int cycle = 0; cycle < WarmupCycles + SoakCycles; cycle++) {
+        if (cycle == WarmupCycles) {
+            fds = openFileDescriptors();
+            memory = memoryInUse();
+        }
+
+        device = -1;
+        QVERIFY(pad.create(phys));
+        if (cycle == 0 && !QTest::qWaitFor([&] { return device != -1; }, 5000))
+            QSKIP("The event nodes of uinput devices are not readable");
+        QTRY_VERIFY_WITH_TIMEOUT(device != -1, 5000);
+
+        QVERIFY(pad.send(EV_KEY, BTN_SOUTH, 1) && pad.sync());
+        QVERIFY(pad.send(EV_KEY, BTN_SOUTH, 0) && pad.sync());
+        QTRY_COMPARE(releases, cycle + 1);
+
+        pad.destroy();
+        QTRY_VERIFY(!input->isJoyConnected(device));
+    }
+
+    QCOMPARE(openFileDescriptors(), fds);
+    const qint64 growth = memoryInUse() - memory;
+    QVERIFY2(growth < MemoryTolerance,
+             qPrintable(u"%1 bytes more in use after %2 cycles"_s.arg(growth).arg(SoakCycles)));
+}
+
+QTEST_GUILESS_MAIN(tst_QLinuxJoystickInput)
+#include "tst_qlinuxjoystickinput.moc"
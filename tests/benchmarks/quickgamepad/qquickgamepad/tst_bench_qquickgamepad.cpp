@@ -0,0 +1,128 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "testpads.h"
+
+#include <QtTest/QTest>
+#include <QtCore/QDeadlineTimer>
+#include <QtGamepad/QGamepad>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlEngine>
+#include <QtUniversalInput/QUniversalInput>
+
+#include <memory>
+
+using namespace Qt::Literals::StringLiterals;
+
+// What a 1 kHz pad reports during a 16 ms frame
+static constexpr int BurstReports = 16;
+static constexpr qint64 ReportInterval = 1000 * 1000;
+
+// Bindings on the individual axis and button properties
+static const char individualBindings[] = R"(
+import QtQuick
+import QtGamepad
+
+Item {
+    Gamepad { id: pad; objectName: "gamepad" }
+    readonly property real stickLength: Math.sqrt(pad.axisLeftX * pad.axisLeftX + pad.axisLeftY * pad.axisLeftY)
+    readonly property bool jump: pad.buttonA
+    readonly property bool menuLeft: pad.buttonLeft
+}
+)";
+
+// The same bindings on the packed properties
+static const char packedBindings[] = R"(
+import QtQuick
+import QtGamepad
+
+Item {
+    Gamepad { id: pad; objectName: "gamepad" }
+    readonly property real stickLength: pad.leftStick.length()
+    readonly property bool jump: pad.buttons & (1 << 0)
+    readonly property bool menuLeft: pad.buttons & (1 << 13)
+}
+)";
+
+class tst_QQuickGamepad : public QObject
+{
+    Q_OBJECT
+
+public:
+    static void initMain();
+
+private slots:
+    void initTestCase();
+    void bindings_data();
+    void bindings();
+
+private:
+    int m_device = -1;
+    qint64 m_timestamp = 0;
+    int m_report = 0;
+};
+
+void tst_QQuickGamepad::initMain()
+{
+    // Headless, and without real devices: only the synthetic events count
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    qputenv("QT_UNIVERSALINPUT_DISABLE_PLUGINS", "1");
+}
+
+void tst_QQuickGamepad::initTestCase()
+{
+    loadUniversalInput();
+
+    m_device = connectTestPad(true);
+    QVERIFY(m_device != -1);
+    m_timestamp = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+}
+
+void tst_QQuickGamepad::bindings_data()
+{
+    QTest::addColumn<QByteArray>("qml");
+    QTest::addColumn<bool>("frameSynchronized");
+
+    QTest::newRow("individual, immediate") << QByteArray(individualBindings) << false;
+    QTest::newRow("individual, frame synchronized") << QByteArray(individualBindings) << true;
+    QTest::newRow("packed, immediate") << QByteArray(packedBindings) << false;
+    QTest::newRow("packed, frame synchronized") << QByteArray(packedBindings) << true;
+}
+
+// One frame worth of a 1 kHz pad, re-evaluating the bindings that depend on
+// the changed properties. Frame synchronized updates publish once per frame.
+void tst_QQuickGamepad::bindings()
+{
+    QFETCH(QByteArray, qml);
+    QFETCH(bool, frameSynchronized);
+
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData(qml, QUrl());
+    std::unique_ptr<QObject> root(component.create());
+    QVERIFY2(root, qPrintable(component.errorString()));
+
+    auto gamepad = root->findChild<QGamepad *>(u"gamepad"_s);
+    QVERIFY(gamepad);
+    gamepad->setDeviceId(m_device);
+    // The item has no window, the frames are driven by synchronize()
+    gamepad->setUpdateMode(frameSynchronized ? QGamepad::FrameSynchronizedUpdates : QGamepad::ImmediateUpdates);
+
+    auto input = QUniversalInput::instance();
+    QBENCHMARK {
+        for (int report = 0; report < BurstReports; report++) {
+            m_timestamp += ReportInterval;
+            const bool on = ++m_report % 2;
+            input->joyAxis(m_device, JoyAxis::LeftX, on ? 0.25f : -0.25f, m_timestamp);
+            input->joyAxis(m_device, JoyAxis::LeftY, on ? -0.75f : 0.75f, m_timestamp);
+            input->joyButton(m_device, JoyButton::A, on, m_timestamp);
+            input->joyHat(m_device, on ? HatMask::Left : HatMask::Center, m_timestamp);
+        }
+        gamepad->synchronize();
+    }
+
+    QVERIFY(root->property("stickLength").toReal() > 0);
+}
+
+QTEST_MAIN(tst_QQuickGamepad)
+#include "tst_bench_qquickgamepad.moc"
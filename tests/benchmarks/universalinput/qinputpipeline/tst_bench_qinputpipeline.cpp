@@ -0,0 +1,226 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "testpads.h"
+
+#include <QtTest/QTest>
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtGamepad/QGamepad>
+#include <QtUniversalInput/QActionStore>
+#include <QtUniversalInput/QUniversalInput>
+
+#include <memory>
+#include <vector>
+
+using namespace Qt::Literals::StringLiterals;
+
+// Pads connected of each kind, the rows use the first ones
+static constexpr int PadsMax = 16;
+// A burst is what a 1 kHz pad reports during a 16 ms frame
+static constexpr int BurstReports = 16;
+static constexpr qint64 ReportInterval = 1000 * 1000;
+// Events a report feeds per pad
+static constexpr int ReportEvents = 4;
+// Each row feeds for at least this long
+static constexpr qint64 MeasureTime = 200 * 1000 * 1000;
+
+class tst_QInputPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    static void initMain();
+
+private slots:
+    void initTestCase();
+    void universalInput_data();
+    void universalInput();
+    void actionStore_data();
+    void actionStore();
+    void gamepad_data();
+    void gamepad();
+
+private:
+    void addRows();
+    QList<int> pads() const;
+    void feed(const QList<int> &pads, bool burst);
+    void measure(const QList<int> &pads, bool burst);
+
+    QList<int> m_mappedPads;
+    QList<int> m_unmappedPads;
+    qint64 m_timestamp = 0;
+    int m_report = 0;
+};
+
+void tst_QInputPipeline::initMain()
+{
+    // Headless, and without real devices: only the synthetic events count
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    qputenv("QT_UNIVERSALINPUT_DISABLE_PLUGINS", "1");
+}
+
+void tst_QInputPipeline::initTestCase()
+{
+    auto input = loadUniversalInput();
+
+    for (int i = 0; i < PadsMax; i++) {
+        const int mapped = connectTestPad(true);
+        QVERIFY(mapped != -1);
+        QVERIFY(input->isGamepad(mapped));
+        m_mappedPads.append(mapped);
+
+        const int unmapped = connectTestPad(false);
+        QVERIFY(unmapped != -1);
+        QVERIFY(!input->isGamepad(unmapped));
+        m_unmappedPads.append(unmapped);
+    }
+
+    m_timestamp = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+}
+
+void tst_QInputPipeline::addRows()
+{
+    QTest::addColumn<int>("padCount");
+    QTest::addColumn<bool>("mapped");
+    QTest::addColumn<bool>("burst");
+
+    for (int padCount : { 1, PadsMax }) {
+        for (bool mapped : { false, true }) {
+            for (bool burst : { false, true }) {
+                QTest::addRow("%d pad%s, %s, %s", padCount, padCount == 1 ? "" : "s",
+                              mapped ? "mapped" : "unmapped", burst ? "1 kHz burst" : "single report")
+                        << padCount << mapped << burst;
+            }
+        }
+    }
+}
+
+QList<int> tst_QInputPipeline::pads() const
+{
+    QFETCH(int, padCount);
+    QFETCH(bool, mapped);
+    return (mapped ? m_mappedPads : m_unmappedPads).first(padCount);
+}
+
+// A report moves the left stick, toggles a button and the hat of every pad.
+// Every event changes the state, so none of them is dropped as a repeat.
+void tst_QInputPipeline::feed(const QList<int> &pads, bool burst)
+{
+    auto input = QUniversalInput::instance();
+    for (int report = 0; report < (burst ? BurstReports : 1); report++) {
+        m_timestamp += ReportInterval;
+        const bool on = ++m_report % 2;
+        for (int device : pads) {
+            input->joyAxis(device, JoyAxis::LeftX, on ? 0.25f : -0.25f, m_timestamp);
+            input->joyAxis(device, JoyAxis::LeftY, on ? -0.75f : 0.75f, m_timestamp);
+            input->joyButton(device, JoyButton::A, on, m_timestamp);
+            input->joyHat(device, on ? HatMask::Left : HatMask::Center, m_timestamp);
+        }
+    }
+}
+
+// The rows feed different numbers of events per iteration. The result is
+// the time per event, so that they compare directly, and the throughput is
+// logged next to it.
+void tst_QInputPipeline::measure(const QList<int> &pads, bool burst)
+{
+    // State allocated on first use is not measured
+    feed(pads, burst);
+
+    const qint64 eventsPerFeed = qint64(burst ? BurstReports : 1) * pads.size() * ReportEvents;
+    qint64 events = 0;
+    QElapsedTimer timer;
+    timer.start();
+    qint64 elapsed = 0;
+    do {
+        // The clock is read rarely, so that it adds nothing to the result
+        for (int i = 0; i < 16; i++)
+            feed(pads, burst);
+        events += 16 * eventsPerFeed;
+        elapsed = timer.nsecsElapsed();
+    } while (elapsed < MeasureTime);
+
+    const qreal nsecsPerEvent = qreal(elapsed) / events;
+    qInfo("%.1f ns/event, %.0f events/s", nsecsPerEvent, 1e9 / nsecsPerEvent);
+    QTest::setBenchmarkResult(nsecsPerEvent, QTest::WalltimeNanoseconds);
+}
+
+void tst_QInputPipeline::universalInput_data()
+{
+    addRows();
+}
+
+// The mapping and the signals of QUniversalInput, with one receiver
+void tst_QInputPipeline::universalInput()
+{
+    QFETCH(bool, burst);
+    const QList<int> devices = pads();
+
+    QObject receiver;
+    int events = 0;
+    connect(QUniversalInput::instance(), &QUniversalInput::joyButtonEvent, &receiver, [&] { ++events; });
+    connect(QUniversalInput::instance(), &QUniversalInput::joyAxisEvent, &receiver, [&] { ++events; });
+
+    measure(devices, burst);
+
+    QVERIFY(events > 0);
+}
+
+void tst_QInputPipeline::actionStore_data()
+{
+    addRows();
+}
+
+// Matching the events against the actions of a QActionStore
+void tst_QInputPipeline::actionStore()
+{
+    QFETCH(bool, burst);
+    const QList<int> devices = pads();
+
+    QActionStore store;
+    store.registerAction(QActionStore::ActionBuilder(u"jump"_s)
+                                 .addButton(QActionStore::Controller::All, JoyButton::A)
+                                 .build());
+    store.registerAction(QActionStore::ActionBuilder(u"moveRight"_s)
+                                 .addAxis(QActionStore::Controller::All, JoyAxis::LeftX,
+                                          QActionStore::AxisDirection::Right, 0.2f)
+                                 .build());
+    store.registerAction(QActionStore::ActionBuilder(u"menuLeft"_s)
+                                 .addButton(QActionStore::Controller::All, JoyButton::DpadLeft)
+                                 .build());
+
+    int actions = 0;
+    connect(&store, &QActionStore::actionEvent, &store, [&] { ++actions; });
+
+    measure(devices, burst);
+
+    QVERIFY(actions > 0);
+}
+
+void tst_QInputPipeline::gamepad_data()
+{
+    addRows();
+}
+
+// Publishing the state through one QGamepad per pad
+void tst_QInputPipeline::gamepad()
+{
+    QFETCH(bool, burst);
+    const QList<int> devices = pads();
+
+    std::vector<std::unique_ptr<QGamepad>> gamepads;
+    int changes = 0;
+    for (int device : devices) {
+        gamepads.push_back(std::make_unique<QGamepad>(device));
+        QGamepad *gamepad = gamepads.back().get();
+        connect(gamepad, &QGamepad::leftStickChanged, gamepad, [&] { ++changes; });
+    }
+
+    measure(devices, burst);
+
+    QVERIFY(changes > 0);
+}
+
+QTEST_MAIN(tst_QInputPipeline)
+#include "tst_bench_qinputpipeline.moc"
@@ -0,0 +1,128 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "latencystats.h"
+#include "testpads.h"
+#include "uinputpad.h"
+
+#include <QtTest/QTest>
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QThread>
+#include <QtUniversalInput/QUniversalInput>
+
+#include <memory>
+#include <vector>
+
+#include <time.h>
+
+// Seconds of events injected per row
+static constexpr int Seconds = 2;
+
+class tst_QLinuxJoystickInput : public QObject
+{
+    Q_OBJECT
+
+public:
+    static void initMain();
+
+private slots:
+    void initTestCase();
+    void latency_data();
+    void latency();
+};
+
+void tst_QLinuxJoystickInput::initMain()
+{
+    UInputPad::selectBackend();
+}
+
+void tst_QLinuxJoystickInput::initTestCase()
+{
+    if (!UInputPad::isAvailable())
+        QSKIP("Needs write access to /dev/uinput");
+
+    loadUniversalInput();
+}
+
+void tst_QLinuxJoystickInput::latency_data()
+{
+    QTest::addColumn<int>("rate");
+
+    for (int rate : { 125, 1000, 4000 })
+        QTest::addRow("%d Hz", rate) << rate;
+}
+
+// Time from the kernel timestamp of a report until QUniversalInput emits the
+// mapped axis event, for a pad reporting at the given rate. The hotplug,
+// reading and the mapping of the backend are all on the way.
+void tst_QLinuxJoystickInput::latency()
+{
+    QFETCH(int, rate);
+    auto input = QUniversalInput::instance();
+    const int reports = rate * Seconds;
+
+    const QByteArray phys = "qt-uinput-latency/" + QByteArray::number(rate);
+    int device = -1;
+    QObject receiver;
+    connect(input, &QUniversalInput::joyConnectionChanged, &receiver, [&](int id, bool isConnected) {
+        if (isConnected && input->joypad(id).physicalId == QLatin1StringView(phys))
+            device = id;
+    });
+
+    std::vector<qint64> latencies;
+    latencies.reserve(reports);
+    connect(input, &QUniversalInput::joyAxisEvent, &receiver, [&](int id, JoyAxis axis, float) {
+        if (id == device && axis == JoyAxis::LeftX)
+            latencies.push_back(QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs() - input->eventTimestamp());
+    });
+
+    UInputPad pad;
+    QVERIFY(pad.create(phys));
+    QTRY_VERIFY_WITH_TIMEOUT(device != -1, 5000);
+    QVERIFY(input->isGamepad(device));
+
+    // Reports on the ticks of an absolute clock, so that a late report
+    // does not shift the following ones
+    int written = 0;
+    std::unique_ptr<QThread> injector(QThread::create([&] {
+        const qint64 period = 1000 * 1000 * 1000 / rate;
+        timespec due;
+        clock_gettime(CLOCK_MONOTONIC, &due);
+        for (int i = 0; i < reports; i++) {
+            due.tv_nsec += period;
+            due.tv_sec += due.tv_nsec / 1000000000;
+            due.tv_nsec %= 1000000000;
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, nullptr);
+            if (!pad.send(EV_ABS, ABS_X, i % 2 ? 16000 : -16000) || !pad.sync())
+                break;
+            written++;
+        }
+    }));
+
+    QEventLoop loop;
+    connect(injector.get(), &QThread::finished, &loop, &QEventLoop::quit);
+    injector->start(QThread::TimeCriticalPriority);
+    loop.exec();
+    // Whatever is still on the way
+    QTest::qWait(100);
+
+    quint64 dropped = 0;
+    const QList<QUniversalInput::DeviceStatistics> statistics = input->statistics();
+    for (const QUniversalInput::DeviceStatistics &entry : statistics) {
+        if (entry.device == device)
+            dropped = entry.droppedEvents;
+    }
+
+    pad.destroy();
+    QTRY_VERIFY(!input->isJoyConnected(device));
+
+    const LatencyStats stats(std::move(latencies));
+    QVERIFY(!stats.isEmpty());
+    qInfo("%d Hz: %s, %d of %d reports lost, %llu SYN_DROPPED", rate, stats.summary().constData(),
+          written - int(stats.count()), written, dropped);
+    QTest::setBenchmarkResult(stats.percentile(0.99), QTest::WalltimeNanoseconds);
+}
+
+QTEST_GUILESS_MAIN(tst_QLinuxJoystickInput)
+#include "tst_bench_qlinuxjoystickinput.moc"
@@ -0,0 +1,53 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef LATENCYSTATS_H
+#define LATENCYSTATS_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/qglobal.h>
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+// Latencies in nanoseconds, summarized the same way by the benchmarks and
+// the latency tools
+class LatencyStats
+{
+public:
+    explicit LatencyStats(std::vector<qint64> latencies)
+        : m_latencies(std::move(latencies))
+    {
+        std::sort(m_latencies.begin(), m_latencies.end());
+    }
+
+    bool isEmpty() const { return m_latencies.empty(); }
+    qsizetype count() const { return qsizetype(m_latencies.size()); }
+
+    qint64 percentile(double p) const
+    {
+        return m_latencies[std::min(m_latencies.size() - 1, size_t(p * m_latencies.size()))];
+    }
+    double mean() const
+    {
+        return std::accumulate(m_latencies.begin(), m_latencies.end(), 0.0) / m_latencies.size();
+    }
+    qint64 max() const { return m_latencies.back(); }
+
+    // Mean, percentiles and maximum in microseconds, on one line
+    QByteArray summary() const
+    {
+        if (isEmpty())
+            return "no samples";
+        return QByteArray::asprintf("mean %8.1f us  p50 %8.1f us  p99 %8.1f us  p99.9 %8.1f us  max %8.1f us",
+                                    mean() / 1000.0, percentile(0.5) / 1000.0, percentile(0.99) / 1000.0,
+                                    percentile(0.999) / 1000.0, max() / 1000.0);
+    }
+
+private:
+    std::vector<qint64> m_latencies;
+};
+
+#endif // LATENCYSTATS_H
@@ -0,0 +1,38 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef TESTPADS_H
+#define TESTPADS_H
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QString>
+#include <QtUniversalInput/QUniversalInput>
+
+// A pad the mapping database knows, and one it does not
+inline const QString MappedPadName = QStringLiteral("Afterglow Xbox 360 Controller");
+inline const QString MappedPadGuid = QStringLiteral("030000006f0e00001302000000010000");
+inline const QString UnmappedPadName = QStringLiteral("Unknown pad");
+inline const QString UnmappedPadGuid = QStringLiteral("03000000ffff0000ffff000000000000");
+
+// QUniversalInput loads the backends and the mapping database once the event
+// loop runs. Tests call this before they connect pads or wait for devices.
+inline QUniversalInput *loadUniversalInput()
+{
+    auto input = QUniversalInput::instance();
+    QCoreApplication::processEvents();
+    return input;
+}
+
+// Connects a synthetic pad under an id of its own. -1 if no id is left.
+inline int connectTestPad(bool mapped)
+{
+    auto input = QUniversalInput::instance();
+    const int device = input->allocateJoyId();
+    if (device == -1)
+        return -1;
+    const bool connected = mapped ? input->updateJoyConnection(device, true, MappedPadName, MappedPadGuid)
+                                  : input->updateJoyConnection(device, true, UnmappedPadName, UnmappedPadGuid);
+    return connected ? device : -1;
+}
+
+#endif // TESTPADS_H
@@ -0,0 +1,106 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef UINPUTPAD_H
+#define UINPUTPAD_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/qglobal.h>
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <linux/uinput.h>
+
+// A virtual Xbox 360 pad created through /dev/uinput, for driving the Linux
+// backend end to end. The mapping database knows the pad, and its phys path
+// tells it apart from real devices.
+class UInputPad
+{
+public:
+    UInputPad() = default;
+    ~UInputPad() { destroy(); }
+    Q_DISABLE_COPY_MOVE(UInputPad)
+
+    static bool isAvailable() { return access("/dev/uinput", W_OK) == 0; }
+
+    // Leaves QUniversalInput only the evdev backend, which picks up the pads
+    // like real ones. Call before QUniversalInput is created.
+    static void selectBackend() { qputenv("QT_UNIVERSALINPUT_BACKENDS", "linux"); }
+
+    bool create(const QByteArray &phys)
+    {
+        destroy();
+        m_fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+        if (m_fd == -1)
+            return false;
+
+        static const int buttons[] = { BTN_SOUTH, BTN_EAST, BTN_NORTH, BTN_WEST, BTN_TL, BTN_TR,
+                                       BTN_SELECT, BTN_START, BTN_MODE, BTN_THUMBL, BTN_THUMBR };
+        ioctl(m_fd, UI_SET_EVBIT, EV_KEY);
+        for (int button : buttons)
+            ioctl(m_fd, UI_SET_KEYBIT, button);
+
+        struct Axis {
+            int code;
+            int minimum;
+            int maximum;
+        };
+        static const Axis axes[] = {
+            { ABS_X, -32768, 32767 },  { ABS_Y, -32768, 32767 },  { ABS_Z, 0, 255 },
+            { ABS_RX, -32768, 32767 }, { ABS_RY, -32768, 32767 }, { ABS_RZ, 0, 255 },
+            { ABS_HAT0X, -1, 1 },      { ABS_HAT0Y, -1, 1 },
+        };
+        ioctl(m_fd, UI_SET_EVBIT, EV_ABS);
+        for (const Axis &axis : axes) {
+            uinput_abs_setup setup = {};
+            setup.code = axis.code;
+            setup.absinfo.minimum = axis.minimum;
+            setup.absinfo.maximum = axis.maximum;
+            if (ioctl(m_fd, UI_SET_ABSBIT, axis.code) < 0 || ioctl(m_fd, UI_ABS_SETUP, &setup) < 0) {
+                destroy();
+                return false;
+            }
+        }
+
+        uinput_setup setup = {};
+        setup.id.bustype = BUS_USB;
+        setup.id.vendor = 0x045e;
+        setup.id.product = 0x028e;
+        setup.id.version = 0x0114;
+        strncpy(setup.name, "Qt uinput pad", UINPUT_MAX_NAME_SIZE - 1);
+        if (ioctl(m_fd, UI_SET_PHYS, phys.constData()) < 0 || ioctl(m_fd, UI_DEV_SETUP, &setup) < 0
+            || ioctl(m_fd, UI_DEV_CREATE) < 0) {
+            destroy();
+            return false;
+        }
+        return true;
+    }
+
+    void destroy()
+    {
+        if (m_fd == -1)
+            return;
+        ioctl(m_fd, UI_DEV_DESTROY);
+        close(m_fd);
+        m_fd = -1;
+    }
+
+    // The kernel stamps the events of a report when they are written
+    bool send(quint16 type, quint16 code, qint32 value)
+    {
+        input_event event = {};
+        event.type = type;
+        event.code = code;
+        event.value = value;
+        return ::write(m_fd, &event, sizeof(event)) == sizeof(event);
+    }
+
+    bool sync() { return send(EV_SYN, SYN_REPORT, 0); }
+
+private:
+    int m_fd = -1;
+};
+
+#endif // UINPUTPAD_H
@@ -0,0 +1,149 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include "evdevcapture.h"
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/uinput.h>
+
+using namespace Qt::Literals::StringLiterals;
+
+static timespec addNSecs(timespec time, qint64 nsecs)
+{
+    nsecs += time.tv_nsec;
+    time.tv_sec += nsecs / 1000000000;
+    time.tv_nsec = nsecs % 1000000000;
+    return time;
+}
+
+static bool createDevice(int fd, const EvdevCapture::Header &header)
+{
+    for (int i = 0; i < EV_CNT; i++) {
+        // Force feedback would need the uploads to be answered, which a
+        // replay has no use for
+        if (i != EV_FF && EvdevCapture::testBit(header.evbit, i))
+            ioctl(fd, UI_SET_EVBIT, i);
+    }
+
+    for (int i = 0; i < KEY_CNT; i++) {
+        if (EvdevCapture::testBit(header.keybit, i))
+            ioctl(fd, UI_SET_KEYBIT, i);
+    }
+
+    for (int i = 0; i < ABS_CNT; i++) {
+        if (!EvdevCapture::testBit(header.absbit, i))
+            continue;
+        uinput_abs_setup absSetup = {};
+        absSetup.code = i;
+        absSetup.absinfo = header.absinfo[i];
+        if (ioctl(fd, UI_SET_ABSBIT, i) < 0 || ioctl(fd, UI_ABS_SETUP, &absSetup) < 0)
+            return false;
+    }
+
+    uinput_setup setup = {};
+    setup.id = header.id;
+    strncpy(setup.name, header.name, UINPUT_MAX_NAME_SIZE - 1);
+    return ioctl(fd, UI_DEV_SETUP, &setup) >= 0 && ioctl(fd, UI_DEV_CREATE) >= 0;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(u"qevdevreplay"_s);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(u"Recreates a captured joypad with uinput and replays its events "
+                                     "with the original timing."_s);
+    parser.addHelpOption();
+    QCommandLineOption delayOption(u"delay"_s,
+                                   u"Milliseconds to wait for the device to be picked up before replaying."_s,
+                                   u"ms"_s, u"1000"_s);
+    QCommandLineOption speedOption(u"speed"_s,
+                                   u"Playback speed factor. 0 replays the events without delays."_s,
+                                   u"factor"_s, u"1"_s);
+    parser.addOption(delayOption);
+    parser.addOption(speedOption);
+    parser.addPositionalArgument(u"capture"_s, u"Capture written with QT_UNIVERSALINPUT_EVDEV_CAPTURE."_s);
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    QFile file(parser.positionalArguments().first());
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open" << file.fileName() << file.errorString();
+        return 1;
+    }
+
+    const qint64 size = file.size();
+    const uchar *data = size >= qint64(sizeof(EvdevCapture::Header)) ? file.map(0, size) : nullptr;
+    EvdevCapture::Header header;
+    if (data)
+        memcpy(&header, data, sizeof(header));
+    if (!data || memcmp(header.magic, EvdevCapture::Magic, sizeof(header.magic)) != 0
+        || header.version != EvdevCapture::Version) {
+        qWarning() << file.fileName() << "is not a supported evdev capture";
+        return 1;
+    }
+
+    int fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK);
+    if (fd == -1) {
+        qWarning() << "Could not open /dev/uinput:" << strerror(errno);
+        return 1;
+    }
+
+    if (!createDevice(fd, header)) {
+        qWarning() << "Could not create uinput device:" << strerror(errno);
+        close(fd);
+        return 1;
+    }
+
+    const timespec delay = { parser.value(delayOption).toInt() / 1000,
+                             (parser.value(delayOption).toInt() % 1000) * 1000000 };
+    nanosleep(&delay, nullptr);
+
+    const double speed = parser.value(speedOption).toDouble();
+    const uchar *events = data + sizeof(EvdevCapture::Header);
+    const qint64 count = (size - qint64(sizeof(EvdevCapture::Header))) / qint64(sizeof(EvdevCapture::Event));
+
+    timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    qint64 firstTime = 0;
+
+    for (qint64 i = 0; i < count; i++) {
+        EvdevCapture::Event captured;
+        memcpy(&captured, events + i * sizeof(captured), sizeof(captured));
+
+        const qint64 time = captured.sec * 1000000000 + captured.usec * 1000;
+        if (i == 0)
+            firstTime = time;
+
+        if (speed > 0) {
+            const timespec due = addNSecs(start, qint64((time - firstTime) / speed));
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, nullptr);
+        }
+
+        input_event event = {};
+        event.type = captured.type;
+        event.code = captured.code;
+        event.value = captured.value;
+        if (write(fd, &event, sizeof(event)) != sizeof(event)) {
+            qWarning() << "Could not write to uinput device:" << strerror(errno);
+            break;
+        }
+    }
+
+    ioctl(fd, UI_DEV_DESTROY);
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+// Measures the time from the scheduled wakeup of an input thread until
+// QUniversalInput emits the event, with and without real-time scheduling,
+// while other threads keep every CPU busy.
+
+#include "latencystats.h"
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QThread>
+#include <QtUniversalInput/QUniversalInput>
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace Qt::Literals::StringLiterals;
+
+static std::vector<qint64> measure(const QUniversalInput::ThreadScheduling &scheduling, int samples, qint64 period)
+{
+    auto input = QUniversalInput::instance();
+
+    std::vector<qint64> latencies;
+    latencies.reserve(samples);
+
+    // Runs on the measuring thread
+    QObject receiver;
+    QObject::connect(input, &QUniversalInput::joyAxisEvent, &receiver, [&](int, JoyAxis, float) {
+        latencies.push_back(QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs() - input->eventTimestamp());
+    }, Qt::DirectConnection);
+
+    std::unique_ptr<QThread> thread(QThread::create([&] {
+        QUniversalInput::applyThreadScheduling(scheduling);
+
+        // The scheduled wakeup time is passed as the event timestamp
+        qint64 wakeup = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+        for (int i = 0; i < samples; i++) {
+            wakeup += period;
+            const qint64 remaining = wakeup - QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+            if (remaining > 0)
+                QThread::usleep(remaining / 1000);
+            input->joyAxis(0, JoyAxis::LeftX, i % 2 ? 0.5f : -0.5f, wakeup);
+        }
+    }));
+    thread->start();
+    thread->wait();
+
+    return latencies;
+}
+
+static void report(const char *label, std::vector<qint64> latencies)
+{
+    printf("%-10s %s\n", label, LatencyStats(std::move(latencies)).summary().constData());
+}
+
+int main(int argc, char *argv[])
+{
+    // Only synthetic events are measured
+    qputenv("QT_UNIVERSALINPUT_DISABLE_PLUGINS", "1");
+
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(u"qinputlatencybench"_s);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(u"Reports wakeup-to-emit latency of the input pipeline with default "
+                                     "and real-time scheduling under synthetic CPU load."_s);
+    parser.addHelpOption();
+    QCommandLineOption samplesOption(u"samples"_s, u"Events per run."_s, u"count"_s, u"5000"_s);
+    QCommandLineOption periodOption(u"period"_s, u"Microseconds between events."_s, u"us"_s, u"1000"_s);
+    QCommandLineOption loadOption(u"load"_s, u"Busy threads generating CPU load, defaults to one per CPU."_s,
+                                  u"threads"_s, QString::number(QThread::idealThreadCount()));
+    QCommandLineOption policyOption(u"policy"_s, u"Real-time policy, fifo or rr."_s, u"policy"_s, u"fifo"_s);
+    QCommandLineOption priorityOption(u"rtprio"_s, u"Real-time priority."_s, u"priority"_s, u"50"_s);
+    QCommandLineOption cpusOption(u"cpus"_s, u"Comma separated CPUs to pin the input thread to."_s, u"cpus"_s);
+    parser.addOptions({ samplesOption, periodOption, loadOption, policyOption, priorityOption, cpusOption });
+    parser.process(app);
+
+    const int samples = parser.value(samplesOption).toInt();
+    const qint64 period = parser.value(periodOption).toLongLong() * 1000;
+
+    QUniversalInput::ThreadScheduling defaultScheduling;
+    const QStringList cpus = parser.value(cpusOption).split(u',', Qt::SkipEmptyParts);
+    for (const QString &cpu : cpus)
+        defaultScheduling.cpus.append(cpu.toInt());
+
+    QUniversalInput::ThreadScheduling realtimeScheduling = defaultScheduling;
+    realtimeScheduling.policy = parser.value(policyOption) == "rr"_L1
+            ? QUniversalInput::ThreadScheduling::RoundRobinPolicy
+            : QUniversalInput::ThreadScheduling::FifoPolicy;
+    realtimeScheduling.realtimePriority = parser.value(priorityOption).toInt();
+
+    std::atomic<bool> loaded { true };
+    std::vector<std::unique_ptr<QThread>> load;
+    for (int i = 0; i < parser.value(loadOption).toInt(); i++) {
+        load.emplace_back(QThread::create([&loaded] {
+            volatile quint64 spin = 0;
+            while (loaded.load(std::memory_order_relaxed))
+                spin = spin + 1;
+        }));
+        load.back()->start(QThread::NormalPriority);
+    }
+
+    printf("%d events every %lld us, %d load threads\n", samples, period / 1000, int(load.size()));
+    report("default", measure(defaultScheduling, samples, period));
+    report("realtime", measure(realtimeScheduling, samples, period));
+
+    loaded = false;
+    for (const auto &thread : load)
+        thread->wait();
+
+    return 0;
+}
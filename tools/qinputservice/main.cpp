@@ -0,0 +1,70 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+// Owns the input devices and serves their mapped events to the processes
+// running with QT_UNIVERSALINPUT_SERVICE=attach.
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTimer>
+#include <QtUniversalInput/QUniversalInput>
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+
+using namespace Qt::Literals::StringLiterals;
+
+static std::atomic<bool> interrupted { false };
+
+static void interrupt(int)
+{
+    interrupted.store(true, std::memory_order_relaxed);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(u"qinputservice"_s);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(u"Serves the mapped events of the local joypads to other processes "
+                                     "through shared memory."_s);
+    parser.addHelpOption();
+    QCommandLineOption keyOption(u"key"_s, u"Name of the shared memory segment."_s, u"key"_s,
+                                 u"qtuniversalinput"_s);
+    QCommandLineOption quietOption(u"quiet"_s, u"Do not report devices connecting."_s);
+    parser.addOptions({ keyOption, quietOption });
+    parser.process(app);
+
+    // Read when QUniversalInput initializes, on the first event loop run
+    qputenv("QT_UNIVERSALINPUT_SERVICE", "publish");
+    qputenv("QT_UNIVERSALINPUT_SERVICE_KEY", parser.value(keyOption).toUtf8());
+    if (!qEnvironmentVariableIsSet("QT_UNIVERSALINPUT_THREAD"))
+        qputenv("QT_UNIVERSALINPUT_THREAD", "1");
+
+    auto input = QUniversalInput::instance();
+    if (!parser.isSet(quietOption)) {
+        QObject::connect(input, &QUniversalInput::joyConnectionChanged, &app, [input](int device, bool isConnected) {
+            if (isConnected)
+                printf("device %d connected: %s\n", device, qPrintable(input->getJoyName(device)));
+            else
+                printf("device %d disconnected\n", device);
+            fflush(stdout);
+        });
+    }
+
+    // Quit through the event loop, so that clients see the devices go
+    std::signal(SIGINT, interrupt);
+    std::signal(SIGTERM, interrupt);
+    QTimer interruptCheck;
+    QObject::connect(&interruptCheck, &QTimer::timeout, &app, [] {
+        if (interrupted.load(std::memory_order_relaxed))
+            QCoreApplication::quit();
+    });
+    interruptCheck.start(100);
+
+    printf("serving input as %s\n", qPrintable(parser.value(keyOption)));
+    fflush(stdout);
+    return QCoreApplication::exec();
+}
@@ -0,0 +1,160 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+// Streams local pads to a remote "udp" joystick backend, or benchmarks the
+// added latency and bandwidth of the protocol over the loopback interface.
+// A backend on another host only listens beyond its loopback interface with
+// QT_UNIVERSALINPUT_UDP_REMOTE set.
+
+#include "latencystats.h"
+#include "remoteinputsender.h"
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtUniversalInput/QUniversalInput>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Qt::Literals::StringLiterals;
+
+static qint64 now()
+{
+    return QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+}
+
+static int send(const QHostAddress &address, quint16 port, const QCommandLineParser &parser,
+                const QCommandLineOption &redundancyOption)
+{
+    RemoteInputSender sender(address, port);
+    sender.setRedundancy(parser.value(redundancyOption).toInt());
+    sender.addDevice(RemoteInputSender::AllDevices);
+
+    printf("streaming local pads to %s:%d\n", qPrintable(address.toString()), port);
+    return QCoreApplication::exec();
+}
+
+// Frame i of the benchmark carries i in the left stick, so that the
+// receiver can look up when it was sent
+static constexpr int CounterRange = 32767;
+
+static int bench(quint16 port, const QCommandLineParser &parser, const QCommandLineOption &redundancyOption,
+                 const QCommandLineOption &rateOption, const QCommandLineOption &samplesOption,
+                 const QCommandLineOption &padsOption, const QCommandLineOption &lossOption)
+{
+    const int rate = qMax(1, parser.value(rateOption).toInt());
+    const int samples = qBound(1, parser.value(samplesOption).toInt(), CounterRange - 1);
+    const int pads = qBound(1, parser.value(padsOption).toInt(), RemoteInput::MaxPads);
+    const int redundancy = parser.value(redundancyOption).toInt();
+    const double loss = parser.value(lossOption).toDouble() / 100.0;
+
+    auto input = QUniversalInput::instance();
+    std::unique_ptr<std::atomic<qint64>[]> sendTimes(new std::atomic<qint64>[samples + 1]);
+    std::vector<qint64> latencies;
+    latencies.reserve(size_t(samples) * pads);
+    int connected = 0;
+
+    QObject receiver;
+    QObject::connect(input, &QUniversalInput::joyConnectionChanged, &receiver, [&](int, bool isConnected) {
+        connected += isConnected ? 1 : -1;
+    });
+    QObject::connect(input, &QUniversalInput::joyAxisEvent, &receiver, [&](int, JoyAxis axis, float value) {
+        const int i = qRound(value * CounterRange);
+        if (axis == JoyAxis::LeftX && i > 0 && i <= samples)
+            latencies.push_back(now() - sendTimes[i].load(std::memory_order_relaxed));
+    });
+
+    quint64 bytesSent = 0;
+    quint64 datagramsSent = 0;
+    std::unique_ptr<QThread> thread(QThread::create([&] {
+        RemoteInputSender sender(QHostAddress::LocalHost, port);
+        sender.setRedundancy(redundancy);
+        sender.setLossRate(loss);
+        for (int pad = 0; pad < pads; pad++)
+            sender.addPad(pad, u"Remote Bench Pad %1"_s.arg(pad));
+        // Give the Hellos time to arrive
+        QThread::msleep(200);
+
+        const auto period = std::chrono::nanoseconds(1000000000 / rate);
+        auto due = std::chrono::steady_clock::now();
+        for (int i = 1; i <= samples; i++) {
+            sendTimes[i].store(now(), std::memory_order_relaxed);
+            RemoteInput::Frame frame;
+            frame.axes[0] = float(i) / CounterRange;
+            for (int pad = 0; pad < pads; pad++)
+                sender.update(pad, frame);
+            due += period;
+            std::this_thread::sleep_until(due);
+        }
+        bytesSent = sender.bytesSent();
+        datagramsSent = sender.datagramsSent();
+    }));
+    // Some time for the plugin to bind before sending
+    QTimer::singleShot(100, thread.get(), [&] { thread->start(); });
+    // Wait for the last frames to play out
+    QObject::connect(thread.get(), &QThread::finished, &receiver, [] {
+        QTimer::singleShot(500, QCoreApplication::instance(), &QCoreApplication::quit);
+    });
+    QCoreApplication::exec();
+
+    const double seconds = double(samples) / rate;
+    printf("%d pads, %d frames at %d Hz, redundancy %d, simulated loss %.1f%%\n",
+           pads, samples, rate, redundancy, loss * 100.0);
+    printf("delivered %zu of %lld frames\n", latencies.size(), qint64(samples) * pads);
+    printf("bandwidth %.0f bytes/s per pad, %.1f bytes per datagram\n",
+           bytesSent / seconds / pads, datagramsSent ? double(bytesSent) / datagramsSent : 0.0);
+    if (!connected)
+        printf("no pad connected, is the udp backend loaded?\n");
+    if (latencies.empty())
+        return 1;
+
+    printf("latency %s\n", LatencyStats(std::move(latencies)).summary().constData());
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    // The benchmark receives through the udp backend on the loopback
+    // interface, nothing else must feed QUniversalInput
+    constexpr quint16 benchPort = RemoteInput::DefaultPort + 1;
+    if (argc > 1 && qstrcmp(argv[1], "bench") == 0) {
+        qputenv("QT_UNIVERSALINPUT_BACKENDS", "udp");
+        qputenv("QT_UNIVERSALINPUT_UDP", "127.0.0.1:" + QByteArray::number(benchPort));
+    }
+
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(u"qremoteinput"_s);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(u"qremoteinput send [host] [port]: streams the local pads to the udp "
+                                     "joystick backend of a remote application.\n"
+                                     "qremoteinput bench: measures latency and bandwidth over loopback."_s);
+    parser.addHelpOption();
+    QCommandLineOption redundancyOption(u"redundancy"_s, u"Earlier frames repeated per datagram."_s,
+                                        u"frames"_s, u"2"_s);
+    QCommandLineOption rateOption(u"rate"_s, u"Benchmark frames per second and pad."_s, u"hz"_s, u"1000"_s);
+    QCommandLineOption samplesOption(u"samples"_s, u"Benchmark frames per pad."_s, u"count"_s, u"5000"_s);
+    QCommandLineOption padsOption(u"pads"_s, u"Benchmark pads."_s, u"count"_s, u"1"_s);
+    QCommandLineOption lossOption(u"loss"_s, u"Benchmark datagrams dropped, in percent."_s, u"percent"_s, u"0"_s);
+    parser.addOptions({ redundancyOption, rateOption, samplesOption, padsOption, lossOption });
+    parser.addPositionalArgument(u"mode"_s, u"send or bench"_s);
+    parser.process(app);
+
+    const QStringList arguments = parser.positionalArguments();
+    if (arguments.value(0) == "bench"_L1)
+        return bench(benchPort, parser, redundancyOption, rateOption, samplesOption, padsOption,
+                     lossOption);
+
+    if (arguments.value(0) != "send"_L1)
+        parser.showHelp(1);
+    const QHostAddress address(arguments.value(1, u"127.0.0.1"_s));
+    const quint16 port = quint16(arguments.value(2).toInt() ? arguments.value(2).toInt() : RemoteInput::DefaultPort);
+    return send(address, port, parser, redundancyOption);
+}
@@ -0,0 +1,167 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include "remoteinputsender.h"
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QTimerEvent>
+#include <QtUniversalInput/QUniversalInput>
+
+using namespace RemoteInput;
+
+static qint64 now()
+{
+    return QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+}
+
+RemoteInputSender::RemoteInputSender(const QHostAddress &address, quint16 port, QObject *parent)
+    : QObject(parent)
+    , m_address(address)
+    , m_port(port)
+{
+}
+
+RemoteInputSender::~RemoteInputSender()
+{
+    const QList<int> pads = m_pads.keys();
+    for (int pad : pads)
+        removePad(pad);
+}
+
+void RemoteInputSender::setRedundancy(int frames)
+{
+    m_redundancy = qBound(0, frames, MaxFrames - 1);
+}
+
+void RemoteInputSender::setHeartbeatInterval(int msecs)
+{
+    m_heartbeatInterval = qint64(msecs) * 1000 * 1000;
+    if (m_heartbeat.isActive())
+        m_heartbeat.start(msecs, this);
+}
+
+void RemoteInputSender::setLossRate(double rate)
+{
+    m_lossRate = rate;
+}
+
+void RemoteInputSender::addDevice(int device)
+{
+    auto input = QUniversalInput::instance();
+    const QList<int> connected = input->connectedJoypads();
+    for (int index : connected) {
+        if (device == AllDevices || index == device)
+            addPad(index, input->getJoyName(index));
+    }
+
+    auto matches = [device](int index) { return device == AllDevices || index == device; };
+    connect(input, &QUniversalInput::joyConnectionChanged, this, [this, matches](int index, bool isConnected) {
+        if (!matches(index))
+            return;
+        if (isConnected)
+            addPad(index, QUniversalInput::instance()->getJoyName(index));
+        else
+            removePad(index);
+    });
+    connect(input, &QUniversalInput::joyButtonEvent, this, [this, matches](int index, JoyButton button, bool isPressed) {
+        if (!matches(index) || !m_pads.contains(index) || int(button) < 0 || int(button) >= 64)
+            return;
+        Frame frame = m_pads[index].history.first();
+        const quint64 bit = quint64(1) << int(button);
+        frame.buttons = isPressed ? frame.buttons | bit : frame.buttons & ~bit;
+        frame.timestamp = QUniversalInput::instance()->eventTimestamp();
+        update(index, frame);
+    });
+    connect(input, &QUniversalInput::joyAxisEvent, this, [this, matches](int index, JoyAxis axis, float value) {
+        if (!matches(index) || !m_pads.contains(index) || int(axis) < 0 || int(axis) >= Axes)
+            return;
+        Frame frame = m_pads[index].history.first();
+        frame.axes[int(axis)] = value;
+        frame.timestamp = QUniversalInput::instance()->eventTimestamp();
+        update(index, frame);
+    });
+}
+
+void RemoteInputSender::addPad(int pad, const QString &name, const QString &guid)
+{
+    if (pad < 0 || pad >= MaxPads)
+        return;
+    Pad &entry = m_pads[pad];
+    entry.name = name;
+    entry.guid = guid;
+    if (entry.history.isEmpty()) {
+        Frame idle;
+        idle.timestamp = now();
+        entry.history.append(idle);
+        send(pad, entry, Hello);
+    }
+
+    if (!m_heartbeat.isActive())
+        m_heartbeat.start(int(m_heartbeatInterval / (1000 * 1000)), this);
+}
+
+void RemoteInputSender::removePad(int pad)
+{
+    const auto it = m_pads.find(pad);
+    if (it == m_pads.end())
+        return;
+
+    send(pad, *it, Bye);
+    m_pads.erase(it);
+    if (m_pads.isEmpty())
+        m_heartbeat.stop();
+}
+
+void RemoteInputSender::update(int pad, Frame frame)
+{
+    const auto it = m_pads.find(pad);
+    if (it == m_pads.end())
+        return;
+
+    frame.sequence = ++it->sequence;
+    if (!frame.timestamp)
+        frame.timestamp = now();
+    it->history.prepend(frame);
+    it->history.resize(qMin(qsizetype(m_redundancy + 1), it->history.size()));
+    send(pad, *it);
+}
+
+void RemoteInputSender::send(int index, Pad &pad, quint8 flags)
+{
+    const qint64 time = now();
+    // Hellos are repeated, a receiver that starts late needs one as well
+    if (time - pad.lastHello >= m_heartbeatInterval && !(flags & Bye))
+        flags |= Hello;
+    if (flags & Hello)
+        pad.lastHello = time;
+    pad.lastSent = time;
+
+    Packet packet;
+    packet.flags = flags;
+    packet.pad = quint8(index);
+    packet.name = pad.name;
+    packet.guid = pad.guid;
+    packet.frames = pad.history;
+
+    const QByteArray datagram = encode(packet);
+    m_bytesSent += datagram.size();
+    m_datagramsSent++;
+    if (m_lossRate > 0.0 && QRandomGenerator::global()->generateDouble() < m_lossRate)
+        return;
+    m_socket.writeDatagram(datagram, m_address, m_port);
+}
+
+void RemoteInputSender::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != m_heartbeat.timerId()) {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    const qint64 time = now();
+    for (auto it = m_pads.begin(); it != m_pads.end(); ++it) {
+        if (time - it->lastSent >= m_heartbeatInterval)
+            send(it.key(), *it);
+    }
+}
@@ -0,0 +1,75 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#ifndef REMOTEINPUTSENDER_H
+#define REMOTEINPUTSENDER_H
+
+#include "remoteinputprotocol.h"
+
+#include <QtCore/QBasicTimer>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QUdpSocket>
+
+// Streams pads to the "udp" joystick backend. Each change is sent right
+// away together with the frames before it, and the current state is
+// repeated while nothing changes, so that the receiver recovers from lost
+// datagrams and notices when the sender goes away.
+class RemoteInputSender : public QObject
+{
+    Q_OBJECT
+public:
+    RemoteInputSender(const QHostAddress &address, quint16 port, QObject *parent = nullptr);
+    ~RemoteInputSender();
+
+    // Earlier frames repeated in every datagram
+    void setRedundancy(int frames);
+    // Milliseconds between repetitions of an unchanged state, and Hellos
+    void setHeartbeatInterval(int msecs);
+    // Fraction of datagrams dropped instead of sent, to exercise recovery
+    void setLossRate(double rate);
+
+    enum { AllDevices = -1 };
+
+    // Streams the mapped events of a QUniversalInput device, or of every
+    // device connected now or later with AllDevices. The receiver gets no
+    // guid, so that they are not mapped a second time.
+    void addDevice(int device);
+
+    void addPad(int pad, const QString &name, const QString &guid = QString());
+    void removePad(int pad);
+    // The sequence number and, if 0, the timestamp are filled in
+    void update(int pad, RemoteInput::Frame frame);
+
+    quint64 bytesSent() const { return m_bytesSent; }
+    quint64 datagramsSent() const { return m_datagramsSent; }
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    struct Pad {
+        QString name;
+        QString guid;
+        QVarLengthArray<RemoteInput::Frame, RemoteInput::MaxFrames> history; // newest first
+        quint32 sequence = 0;
+        qint64 lastHello = 0;
+        qint64 lastSent = 0;
+    };
+
+    void send(int index, Pad &pad, quint8 flags = 0);
+
+    QUdpSocket m_socket;
+    QHostAddress m_address;
+    quint16 m_port;
+    int m_redundancy = 2;
+    qint64 m_heartbeatInterval = 100 * 1000 * 1000;
+    double m_lossRate = 0.0;
+    QMap<int, Pad> m_pads;
+    QBasicTimer m_heartbeat;
+    quint64 m_bytesSent = 0;
+    quint64 m_datagramsSent = 0;
+};
+
+#endif // REMOTEINPUTSENDER_H
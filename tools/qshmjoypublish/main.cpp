@@ -0,0 +1,91 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+// Publishes synthetic pads to the shared memory segment read by the "shm"
+// joystick backend, at a fixed rate, for load tests and as an example of
+// the qshmjoystick.h API.
+
+#include "qshmjoystick.h"
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+using namespace Qt::Literals::StringLiterals;
+
+static volatile std::sig_atomic_t interrupted = 0;
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(u"qshmjoypublish"_s);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(u"Publishes synthetic pads for the shm joystick backend, run the "
+                                     "application with QT_UNIVERSALINPUT_BACKENDS=shm."_s);
+    parser.addHelpOption();
+    QCommandLineOption nameOption(u"name"_s, u"Shared memory segment."_s, u"name"_s,
+                                  QString::fromLatin1(QSHMJOY_DEFAULT_NAME));
+    QCommandLineOption devicesOption(u"devices"_s, u"Pads to publish."_s, u"count"_s, u"1"_s);
+    QCommandLineOption rateOption(u"rate"_s, u"Frames per second and pad."_s, u"hz"_s, u"1000"_s);
+    QCommandLineOption durationOption(u"duration"_s, u"Seconds to run, 0 until interrupted."_s,
+                                      u"seconds"_s, u"0"_s);
+    parser.addOptions({ nameOption, devicesOption, rateOption, durationOption });
+    parser.process(app);
+
+    const QByteArray name = parser.value(nameOption).toLocal8Bit();
+    const int devices = qBound(1, parser.value(devicesOption).toInt(), QSHMJOY_MAX_DEVICES);
+    const int rate = qMax(1, parser.value(rateOption).toInt());
+    const double duration = parser.value(durationOption).toDouble();
+
+    QShmJoySegment *segment = qshmjoy_create(name.constData());
+    if (!segment) {
+        qWarning() << "Could not create" << name << strerror(errno);
+        return 1;
+    }
+
+    for (int i = 0; i < devices; i++)
+        qshmjoy_connect(segment, i, QByteArray("Synthetic Pad " + QByteArray::number(i)).constData(), "");
+
+    std::signal(SIGINT, [](int) { interrupted = 1; });
+    std::signal(SIGTERM, [](int) { interrupted = 1; });
+
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::nanoseconds(1000000000 / rate);
+    const auto start = Clock::now();
+    auto due = start;
+    quint64 frames = 0;
+
+    while (!interrupted && (duration <= 0 || std::chrono::duration<double>(Clock::now() - start).count() < duration)) {
+        const double t = std::chrono::duration<double>(due - start).count();
+        for (int i = 0; i < devices; i++) {
+            // Sticks circle once a second, face buttons cycle every 100 ms
+            QShmJoyFrame frame = {};
+            frame.timestamp = qshmjoy_now();
+            frame.axes[0] = float(std::cos(2 * M_PI * t + i));
+            frame.axes[1] = float(std::sin(2 * M_PI * t + i));
+            frame.buttons = quint64(1) << ((frames / (rate / 10 + 1)) % 4);
+            qshmjoy_publish(segment, i, &frame);
+        }
+        frames++;
+
+        due += period;
+        std::this_thread::sleep_until(due);
+    }
+
+    for (int i = 0; i < devices; i++)
+        qshmjoy_disconnect(segment, i);
+    qshmjoy_close(segment);
+    qshmjoy_unlink(name.constData());
+
+    printf("published %llu frames per pad\n", static_cast<unsigned long long>(frames));
+    return 0;
+}